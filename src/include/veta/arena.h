@@ -0,0 +1,196 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_ARENA_H
+#define VETA_ARENA_H
+
+#include <memory_resource>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <ostream>
+
+namespace ns_veta {
+
+    /**
+    * @brief statistics of an 'ArenaResource', to tune its chunk size
+    */
+    struct ArenaStats {
+    public:
+        // chunks currently held, and the ones dedicated to allocations larger than the chunk size
+        std::size_t chunks = 0, largeChunks = 0;
+        // bytes of the chunks currently held
+        std::size_t reservedBytes = 0;
+        // bytes handed out (including the alignment padding), the rest of the chunks is unused
+        std::size_t usedBytes = 0;
+        // bytes left at the end of the chunks when a new chunk was needed
+        std::size_t wastedBytes = 0;
+        // calls to allocate and deallocate, deallocations are no-ops: the memory is given back by 'Release'
+        std::size_t allocations = 0, deallocations = 0;
+        std::size_t largestAllocation = 0;
+
+        friend std::ostream &operator<<(std::ostream &os, const ArenaStats &stats);
+    };
+
+    /**
+    * @brief A monotonic memory resource: allocations are bumped from large chunks taken from the upstream resource,
+    * deallocations do nothing, and all the chunks are given back at once by 'Release' or by the destructor, in
+    * O(number of chunks). Allocations are serialized by a mutex unless the arena is created unsynchronized.
+    * @note for a scene ('Veta'), only the map nodes come from the arena, and only under 'VETA_ARENA_CONTAINERS' (off
+    * by default): the shared views and intrinsics stay on the heap, and destroying a scene still runs the
+    * destructor of each node (without freeing it), so that it is linear in the number of elements, not in the
+    * number of chunks
+    */
+    class ArenaResource : public std::pmr::memory_resource {
+    public:
+        using Ptr = std::shared_ptr<ArenaResource>;
+
+        static constexpr std::size_t DefaultChunkSize = std::size_t(4) << 20;
+
+    protected:
+        struct Chunk {
+            void *data;
+            std::size_t size;
+        };
+
+        std::pmr::memory_resource *upstream;
+        std::size_t chunkSize;
+
+        // whether 'mutex' is taken, an unsynchronized arena must only be used by one thread at a time
+        bool synchronized;
+        mutable std::mutex mutex;
+        std::vector<Chunk> chunks;
+        // the free part of the current chunk
+        char *cur = nullptr, *end = nullptr;
+        ArenaStats stats;
+
+    public:
+        /**
+        * @param synchronized false to skip the mutex, e.g. for a scene loaded and used by a single thread. The
+        * parallel passes (e.g. 'CompactIds', 'ShardedLandmarks') allocate from the resource of the scene on several
+        * threads, they require a synchronized arena
+        */
+        explicit ArenaResource(std::size_t chunkSize = DefaultChunkSize,
+                               std::pmr::memory_resource *upstream = std::pmr::new_delete_resource(),
+                               bool synchronized = true);
+
+        static Ptr Create(std::size_t chunkSize = DefaultChunkSize,
+                          std::pmr::memory_resource *upstream = std::pmr::new_delete_resource(),
+                          bool synchronized = true);
+
+        ArenaResource(const ArenaResource &) = delete;
+
+        ArenaResource &operator=(const ArenaResource &) = delete;
+
+        ~ArenaResource() override;
+
+        /**
+        * @brief give all the chunks back to the upstream resource, nothing allocated from the arena may be used
+        * afterwards
+        */
+        void Release();
+
+        [[nodiscard]] std::size_t ChunkSize() const;
+
+        [[nodiscard]] ArenaStats Stats() const;
+
+        [[nodiscard]] bool Synchronized() const;
+
+    protected:
+        [[nodiscard]] std::unique_lock<std::mutex> Lock() const;
+
+        void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+        void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override;
+
+        [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+    };
+
+    /**
+    * @brief the memory resource of the containers default-constructed by this thread ('ResourceAllocator'),
+    * nullptr for the heap
+    */
+    const std::shared_ptr<std::pmr::memory_resource> &CurrentResource();
+
+    /**
+    * @brief set the current memory resource of this thread for the lifetime of the object, the previous one is
+    * restored by the destructor
+    * @note the containers default-constructed in the scope do not keep the resource alive (see 'ResourceAllocator')
+    */
+    class ScopedResource {
+    protected:
+        std::shared_ptr<std::pmr::memory_resource> previous;
+
+    public:
+        explicit ScopedResource(std::shared_ptr<std::pmr::memory_resource> resource);
+
+        ScopedResource(const ScopedResource &) = delete;
+
+        ScopedResource &operator=(const ScopedResource &) = delete;
+
+        ~ScopedResource();
+    };
+
+    /**
+    * @brief An allocator drawing from a memory resource (the heap if null), which it does not own: the resource must
+    * outlive the containers, e.g. a scene ('Veta') keeps its resource alive, so that nothing allocated from the
+    * scene may be used after it is destroyed. Default-constructed allocators, and so the copies of containers,
+    * use the 'CurrentResource' of the thread.
+    */
+    template<typename Type>
+    class ResourceAllocator {
+    public:
+        using value_type = Type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template<typename Other>
+        struct rebind {
+            using other = ResourceAllocator<Other>;
+        };
+
+    protected:
+        template<typename Other> friend
+        class ResourceAllocator;
+
+        std::pmr::memory_resource *resource;
+
+    public:
+        ResourceAllocator() : resource(CurrentResource().get()) {}
+
+        explicit ResourceAllocator(std::pmr::memory_resource *resource) : resource(resource) {}
+
+        template<typename Other>
+        ResourceAllocator(const ResourceAllocator<Other> &other) : resource(other.resource) {}
+
+        Type *allocate(std::size_t n) {
+            return static_cast<Type *>(Resource()->allocate(n * sizeof(Type), alignof(Type)));
+        }
+
+        void deallocate(Type *p, std::size_t n) {
+            Resource()->deallocate(p, n * sizeof(Type), alignof(Type));
+        }
+
+        [[nodiscard]] ResourceAllocator select_on_container_copy_construction() const {
+            return ResourceAllocator();
+        }
+
+        [[nodiscard]] std::pmr::memory_resource *Resource() const {
+            return resource ? resource : std::pmr::new_delete_resource();
+        }
+
+        template<typename Other>
+        bool operator==(const ResourceAllocator<Other> &other) const {
+            return Resource()->is_equal(*other.Resource());
+        }
+
+        template<typename Other>
+        bool operator!=(const ResourceAllocator<Other> &other) const {
+            return !(*this == other);
+        }
+    };
+}
+
+#endif //VETA_ARENA_H
@@ -156,6 +156,14 @@ namespace ns_veta {
         */
         [[nodiscard]] virtual Vec2d Project(const Vec3d &X, bool ignoreDisto) const;
 
+        /**
+        * @brief Compute projections of 3D points (one per column) into the image plane
+        * @param X 3D-points to project on image plane
+        * @param ignoreDisto whether the distortion (if any) is ignored
+        * @return Projected (2D) points on image plane
+        */
+        [[nodiscard]] virtual Mat2Xd ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const;
+
         /**
         * @brief Compute the Residual between the 3D projected point and an image observation
         * @param X 3d point to Project on camera plane
@@ -164,6 +172,15 @@ namespace ns_veta {
         */
         [[nodiscard]] Vec2d Residual(const Vec3d &X, const Vec2d &x, bool ignoreDisto = false) const;
 
+        /**
+        * @brief Compute the residuals between 3D points (one per column) projected by 'ProjectPoints' and their
+        * image observations, by the dispatched 'SimdKernels::residuals' kernel
+        * @param X 3d points to Project on camera plane
+        * @param x image observations
+        * @return Relative 2d distances between projected and observed points
+        */
+        [[nodiscard]] Mat2Xd Residuals(const Mat3Xd &X, const Mat2Xd &x, bool ignoreDisto = false) const;
+
         // ---------------
         // Virtual members
         // ---------------
@@ -178,7 +195,7 @@ namespace ns_veta {
         * @brief Data wrapper for non linear optimization (get data)
         * @return vector of parameter of this intrinsic
         */
-        [[nodiscard]] virtual std::vector<double> GetParams() const = 0;
+        [[nodiscard]] virtual std::vector<double> GetParams() const;
 
         /**
         * @brief Data wrapper for non linear optimization (update from data)
@@ -186,7 +203,36 @@ namespace ns_veta {
         * @retval true if update is correct
         * @retval false if there was an error during update
         */
-        virtual bool UpdateFromParams(const std::vector<double> &params) = 0;
+        virtual bool UpdateFromParams(const std::vector<double> &params);
+
+        /**
+        * @brief Data wrapper for non linear optimization (update in place from a raw block)
+        * @param params 'size' parameters laid out as 'GetParams()', may be 'ParamsAddress()' itself
+        * @param size number of parameters
+        * @retval true if update is correct
+        * @retval false if 'size' does not match 'ParamsSize()'
+        */
+        bool UpdateFromParams(const double *params, std::size_t size);
+
+        /**
+        * @brief The raw parameter block, laid out as 'GetParams()'. Its address is stable, so an optimizer can
+        * write into it directly, the writes take effect immediately
+        * @return the first parameter, nullptr if the camera model does not have any parameter
+        */
+        [[nodiscard]] virtual double *ParamsAddress();
+
+        [[nodiscard]] virtual const double *ParamsAddress() const;
+
+        /**
+        * @brief Number of parameters in the raw parameter block
+        */
+        [[nodiscard]] virtual std::size_t ParamsSize() const;
+
+        /**
+        * @brief Hook for the camera models keeping state derived from the raw parameter block, to call after
+        * writing into it. None of the built-in models derives any state
+        */
+        virtual void UpdateDerived();
 
         /**
         * @brief Return the list of parameter indexes that must be held constant
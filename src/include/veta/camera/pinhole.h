@@ -6,8 +6,30 @@
 #define VETA_PINHOLE_H
 
 #include "veta/camera/intrinsics.h"
+#include <array>
 
 namespace ns_veta {
+
+    /**
+    * @brief Horner evaluation of k[I] + x * (k[I + 1] + x * (... + x * k[N - 1])), unrolled at compile time
+    */
+    template<std::size_t I, std::size_t N>
+    inline double HornerTail(const double *k, double x) {
+        if constexpr (I == N) {
+            return 0.0;
+        } else {
+            return k[I] + x * HornerTail<I + 1, N>(k, x);
+        }
+    }
+
+    /**
+    * @brief Evaluate the radial polynomial 1 + k[0] * x + k[1] * x^2 + ... + k[N - 1] * x^N
+    * @tparam N number of coefficients
+    */
+    template<std::size_t N>
+    inline double RadialPolynomial(const double *k, double x) {
+        return 1.0 + x * HornerTail<0, N>(k, x);
+    }
     /**
     * @brief Define an ideal Pinhole camera intrinsics (store a KMat 3x3 matrix)
     * with intrinsic parameters defining the KMat calibration matrix
@@ -25,11 +47,18 @@ namespace ns_veta {
 
     protected:
 
-        // Intrinsic matrix : Focal & principal point are embed into the calibration matrix KMat
-        Mat3d K;
+        // Largest number of distortion coefficients of the pinhole camera models
+        static constexpr std::size_t MaxDistoCount = 5;
 
-        // Inverse of intrinsic matrix
-        Mat3d KInv;
+        // Raw parameter block: fx, fy, cx, cy and then the distortion coefficients (if any), stored inline.
+        // Every projection reads it directly, so writes through its addresses take effect immediately
+        std::array<double, 4 + MaxDistoCount> params{1.0, 1.0, 0.0, 0.0};
+
+        // Number of distortion coefficients stored in 'params'
+        std::size_t distoCount = 0;
+
+        // Skew of the intrinsic matrix (zero unless given by the matrix constructor)
+        double skew = 0.0;
 
     public:
 
@@ -43,7 +72,7 @@ namespace ns_veta {
         */
         explicit PinholeIntrinsic(unsigned int w, unsigned int h, double fx, double fy, double ppx, double ppy);
 
-        PinholeIntrinsic() = default;
+        PinholeIntrinsic();
 
         /**
         * @brief Constructor
@@ -69,11 +98,14 @@ namespace ns_veta {
         [[nodiscard]] Eintrinsic GetType() const override;
 
         /**
-        * @brief Get the intrinsic matrix
+        * @brief Get the intrinsic matrix, built from the raw parameter block
         * @return 3x3 intrinsic matrix
         */
-        [[nodiscard]] const Mat3d &KMat() const;
+        [[nodiscard]] Mat3d KMat() const;
 
+        /**
+        * @brief Addresses into the raw parameter block, the writes through them take effect immediately
+        */
         double *FXAddress();
 
         double *FYAddress();
@@ -82,13 +114,16 @@ namespace ns_veta {
 
         double *CYAddress();
 
+        /**
+        * @return the first distortion coefficient, nullptr if the camera model does not handle distortion
+        */
         virtual double *DistCoeffAddress();
 
         /**
-        * @brief Get the Inverse of the intrinsic matrix
+        * @brief Get the Inverse of the intrinsic matrix, built from the raw parameter block
         * @return Inverse of intrinsic matrix
         */
-        [[nodiscard]] const Mat3d &KInvMat() const;
+        [[nodiscard]] Mat3d KInvMat() const;
 
 
         /**
@@ -110,11 +145,27 @@ namespace ns_veta {
         [[nodiscard]] Vec2d PrincipalPoint() const;
 
         /**
-        * @brief Get bearing vectors from image coordinates
+        * @brief Get bearing vectors from image coordinates, the distortion (if any) is removed. Large sets of
+        * points are processed in parallel
         * @return bearing vectors
         */
         Mat3Xd operator()(const Mat2Xd &points) const override;
 
+        /**
+        * @brief Remove the distortion of camera plane points (one per column), see 'RemoveDisto'
+        * @param p Points with distortion
+        * @return Points without distortion
+        */
+        [[nodiscard]] virtual Mat2Xd RemoveDistoPoints(const Mat2Xd &p) const;
+
+        /**
+        * @brief Compute projections of 3D points (one per column) into the image plane
+        * @param X 3D-points to project on image plane
+        * @param ignoreDisto whether the distortion (if any) is ignored
+        * @return Projected (2D) points on image plane
+        */
+        [[nodiscard]] Mat2Xd ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const override;
+
         /**
         * @brief Transform a point from the camera plane to the image plane
         * @param p Camera plane point
@@ -165,19 +216,13 @@ namespace ns_veta {
 
 
         /**
-        * @brief Data wrapper for non linear optimization (get data)
-        * @return vector of parameter of this intrinsic
+        * @brief The raw parameter block: fx, fy, cx, cy and then the distortion coefficients (if any)
         */
-        [[nodiscard]] std::vector<double> GetParams() const override;
+        [[nodiscard]] double *ParamsAddress() override;
 
+        [[nodiscard]] const double *ParamsAddress() const override;
 
-        /**
-        * @brief Data wrapper for non linear optimization (update from data)
-        * @param params List of params used to update this intrinsic
-        * @retval true if update is correct
-        * @retval false if there was an error during update
-        */
-        bool UpdateFromParams(const std::vector<double> &params) override;
+        [[nodiscard]] std::size_t ParamsSize() const override;
 
         /**
         * @brief Return the list of parameter indexes that must be held constant
@@ -207,10 +252,10 @@ namespace ns_veta {
         template<class Archive>
         inline void save(Archive &ar) const {
             IntrinsicBase::save(ar);
-            const std::vector<double> focalLength{K(0, 0), K(1, 1)};
+            const std::vector<double> focalLength{params[0], params[1]};
             ar(cereal::make_nvp("focal_length_note", std::string("fx, fy")));
             ar(cereal::make_nvp("focal_length", focalLength));
-            const std::vector<double> pp{K(0, 2), K(1, 2)};
+            const std::vector<double> pp{params[2], params[3]};
             ar(cereal::make_nvp("principal_point_note", std::string("cx, cy")));
             ar(cereal::make_nvp("principal_point", pp));
         }
@@ -229,7 +274,10 @@ namespace ns_veta {
             std::vector<double> pp(2);
             ar(cereal::make_nvp("principal_point_note", std::string("cx, cy"))); // useless
             ar(cereal::make_nvp("principal_point", pp));
-            *this = PinholeIntrinsic(imgWidth, imgHeight, focalLength[0], focalLength[1], pp[0], pp[1]);
+            // the distortion coefficients (if any) stored after fx, fy, cx, cy are kept
+            params[0] = focalLength[0], params[1] = focalLength[1], params[2] = pp[0], params[3] = pp[1];
+            skew = 0.0;
+            UpdateDerived();
         }
 
         /**
@@ -237,6 +285,19 @@ namespace ns_veta {
         * @return A Clone (copy of the stored object)
         */
         [[nodiscard]] IntrinsicBase *Clone() const override;
+
+    protected:
+        /**
+        * @brief Constructor used by the distorted camera models
+        * @param disto the distortion coefficients, stored after fx, fy, cx, cy in the parameter block
+        */
+        PinholeIntrinsic(unsigned int w, unsigned int h, double fx, double fy, double ppx, double ppy,
+                         std::initializer_list<double> disto);
+
+        /**
+        * @brief The distortion coefficients, stored after fx, fy, cx, cy in the parameter block
+        */
+        [[nodiscard]] const double *DistoParams() const;
     };
 
 }
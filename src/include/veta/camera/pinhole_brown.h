@@ -19,10 +19,8 @@ namespace ns_veta {
 
         using class_type = PinholeIntrinsicBrownT2;
 
-    protected:
-
-        // Center of distortion is applied by the Intrinsics class
-        std::vector<double> params; // K1, K2, K3, T1, T2
+        // Number of distortion coefficients (k1, k2, k3, t1, t2)
+        static constexpr std::size_t DistoCount = 5;
 
     public:
 
@@ -43,7 +41,9 @@ namespace ns_veta {
                                          double k1 = 0.0, double k2 = 0.0, double k3 = 0.0,
                                          double t1 = 0.0, double t2 = 0.0);
 
-        PinholeIntrinsicBrownT2() = default;
+        PinholeIntrinsicBrownT2() : PinholeIntrinsic() {
+            distoCount = DistoCount;
+        }
 
         static Ptr Create(int w, int h, double fx, double fy, double ppx, double ppy,
                           double k1 = 0.0, double k2 = 0.0, double k3 = 0.0,
@@ -79,20 +79,20 @@ namespace ns_veta {
         [[nodiscard]] Vec2d RemoveDisto(const Vec2d &p) const override;
 
         /**
-        * @brief Data wrapper for non linear optimization (get data)
-        * @return vector of parameter of this intrinsic
+        * @brief Remove the distortion of camera plane points (one per column), vectorized
+        * @param p Points with distortion
+        * @return Points without distortion
         */
-        [[nodiscard]] std::vector<double> GetParams() const override;
-
-        double *DistCoeffAddress() override;
+        [[nodiscard]] Mat2Xd RemoveDistoPoints(const Mat2Xd &p) const override;
 
         /**
-        * @brief Data wrapper for non linear optimization (update from data)
-        * @param paramsVec List of paramsVec used to update this intrinsic
-        * @retval true if update is correct
-        * @retval false if there was an error during update
+        * @brief Compute projections of 3D points (one per column) into the image plane, by the dispatched
+        * 'SimdKernels::projectBrown' kernel
+        * @param X 3D-points to project on image plane
+        * @param ignoreDisto whether the distortion is ignored
+        * @return Projected (2D) points on image plane
         */
-        bool UpdateFromParams(const std::vector<double> &paramsVec) override;
+        [[nodiscard]] Mat2Xd ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const override;
 
         /**
         * @brief Return the list of parameter indexes that must be held constant
@@ -122,8 +122,9 @@ namespace ns_veta {
         template<class Archive>
         inline void save(Archive &ar) const {
             PinholeIntrinsic::save(ar);
+            const std::vector<double> disto(params.cbegin() + 4, params.cbegin() + 4 + distoCount);
             ar(cereal::make_nvp("disto_param_note", std::string("k1, k2, k3, t1, t2")));
-            ar(cereal::make_nvp("disto_param", params));
+            ar(cereal::make_nvp("disto_param", disto));
         }
 
         /**
@@ -133,13 +134,16 @@ namespace ns_veta {
         template<class Archive>
         inline void load(Archive &ar) {
             PinholeIntrinsic::load(ar);
+            std::vector<double> disto;
             ar(cereal::make_nvp("disto_param_note", std::string("k1, k2, k3, t1, t2"))); //useless
-            ar(cereal::make_nvp("disto_param", params));
-            if (params.size() != 5) {
+            ar(cereal::make_nvp("disto_param", disto));
+            if (disto.size() != DistoCount) {
                 throw std::runtime_error(
                         "camera model 'pinhole_brown_t2' should maintain five distortion parameters (k1, k2, k3, t1, t2)"
                 );
             }
+            std::copy(disto.cbegin(), disto.cend(), params.begin() + 4);
+            distoCount = DistoCount;
         }
 
         /**
@@ -157,7 +161,7 @@ namespace ns_veta {
         * @param p Input point
         * @return Transformed point
         */
-        static Vec2d DistoFunction(const std::vector<double> &params, const Vec2d &p);
+        static Vec2d DistoFunction(const double *params, const Vec2d &p);
     };
 
 }
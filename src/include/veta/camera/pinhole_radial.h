@@ -17,7 +17,7 @@ namespace ns_veta {
     * @return Best radius
     */
     template<class Disto_Functor>
-    double BisectionRadiusSolve(const std::vector<double> &params,
+    double BisectionRadiusSolve(const double *params,
                                 double r2, Disto_Functor &functor,
                                 double epsilon = 1e-10) {
         // Guess plausible upper and lower bound
@@ -41,7 +41,6 @@ namespace ns_veta {
         return .5 * (lowerBound + upBound);
     }
 
-
     /**
      * @brief Implement a Pinhole camera with a 1 radial distortion coefficient.
      * \f$ x_d = x_u (1 + K_1 r^2 ) \f$
@@ -52,9 +51,8 @@ namespace ns_veta {
 
         using class_type = PinholeIntrinsicRadialK1;
 
-    protected:
-        /// Center of distortion is applied by the Intrinsics class
-        std::vector<double> params; // K1
+        // Number of distortion coefficients (k1)
+        static constexpr std::size_t DistoCount = 1;
 
     public:
 
@@ -68,9 +66,12 @@ namespace ns_veta {
         * @param k1 Distortion coefficient
         */
         explicit PinholeIntrinsicRadialK1(int w, int h, double fx, double fy, double ppx, double ppy, double k1 = 0.0)
-                : PinholeIntrinsic(w, h, fx, fy, ppx, ppy), params({k1}) {}
+                : PinholeIntrinsic(w, h, fx, fy, ppx, ppy, {k1}) {}
 
-        PinholeIntrinsicRadialK1() = default;
+        // no distortion, the coefficients are counted so that the parameter block has its full size (as in 'load')
+        PinholeIntrinsicRadialK1() : PinholeIntrinsic() {
+            distoCount = DistoCount;
+        }
 
         ~PinholeIntrinsicRadialK1() override = default;
 
@@ -104,20 +105,20 @@ namespace ns_veta {
         [[nodiscard]] Vec2d RemoveDisto(const Vec2d &p) const override;
 
         /**
-        * @brief Data wrapper for non linear optimization (get data)
-        * @return vector of parameter of this intrinsic
+        * @brief Remove the distortion of camera plane points (one per column), vectorized
+        * @param p Points with distortion
+        * @return Points without distortion
         */
-        [[nodiscard]] std::vector<double> GetParams() const override;
-
-        double *DistCoeffAddress() override;
+        [[nodiscard]] Mat2Xd RemoveDistoPoints(const Mat2Xd &p) const override;
 
         /**
-        * @brief Data wrapper for non linear optimization (update from data)
-        * @param paramsVec List of paramsVec used to update this intrinsic
-        * @retval true if update is correct
-        * @retval false if there was an error during update
+        * @brief Compute projections of 3D points (one per column) into the image plane, by the dispatched
+        * 'SimdKernels::projectRadial' kernel
+        * @param X 3D-points to project on image plane
+        * @param ignoreDisto whether the distortion is ignored
+        * @return Projected (2D) points on image plane
         */
-        bool UpdateFromParams(const std::vector<double> &paramsVec) override;
+        [[nodiscard]] Mat2Xd ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const override;
 
         /**
         * @brief Return the list of parameter indexes that must be held constant
@@ -147,8 +148,9 @@ namespace ns_veta {
         template<class Archive>
         inline void save(Archive &ar) const {
             PinholeIntrinsic::save(ar);
+            const std::vector<double> disto(params.cbegin() + 4, params.cbegin() + 4 + distoCount);
             ar(cereal::make_nvp("disto_param_note", std::string("k1")));
-            ar(cereal::make_nvp("disto_param", params));
+            ar(cereal::make_nvp("disto_param", disto));
         }
 
         /**
@@ -158,13 +160,16 @@ namespace ns_veta {
         template<class Archive>
         inline void load(Archive &ar) {
             PinholeIntrinsic::load(ar);
+            std::vector<double> disto;
             ar(cereal::make_nvp("disto_param_note", std::string("k1"))); //useless
-            ar(cereal::make_nvp("disto_param", params));
-            if (params.size() != 1) {
+            ar(cereal::make_nvp("disto_param", disto));
+            if (disto.size() != DistoCount) {
                 throw std::runtime_error(
                         "camera model 'pinhole_radial_k1' should maintain one distortion parameter (k1)"
                 );
             }
+            std::copy(disto.cbegin(), disto.cend(), params.begin() + 4);
+            distoCount = DistoCount;
         }
 
         /**
@@ -181,7 +186,7 @@ namespace ns_veta {
         * @param r2 square distance (relative to Center)
         * @return distance
         */
-        static double DistoFunctor(const std::vector<double> &params, double r2);
+        static double DistoFunctor(const double *params, double r2);
     };
 
     /**
@@ -194,10 +199,8 @@ namespace ns_veta {
 
         using class_type = PinholeIntrinsicRadialK3;
 
-    protected:
-        // Center of distortion is applied by the Intrinsics class
-        /// K1, K2, K3
-        std::vector<double> params;
+        // Number of distortion coefficients (k1, k2, k3)
+        static constexpr std::size_t DistoCount = 3;
 
     public:
 
@@ -214,9 +217,11 @@ namespace ns_veta {
         */
         explicit PinholeIntrinsicRadialK3(int w, int h, double fx, double fy, double ppx, double ppy,
                                           double k1 = 0.0, double k2 = 0.0, double k3 = 0.0)
-                : PinholeIntrinsic(w, h, fx, fy, ppx, ppy), params({k1, k2, k3}) {}
+                : PinholeIntrinsic(w, h, fx, fy, ppx, ppy, {k1, k2, k3}) {}
 
-        PinholeIntrinsicRadialK3() = default;
+        PinholeIntrinsicRadialK3() : PinholeIntrinsic() {
+            distoCount = DistoCount;
+        }
 
         ~PinholeIntrinsicRadialK3() override = default;
 
@@ -250,18 +255,20 @@ namespace ns_veta {
         [[nodiscard]] Vec2d RemoveDisto(const Vec2d &p) const override;
 
         /**
-        * @brief Data wrapper for non linear optimization (get data)
-        * @return vector of parameter of this intrinsic
+        * @brief Remove the distortion of camera plane points (one per column), vectorized
+        * @param p Points with distortion
+        * @return Points without distortion
         */
-        [[nodiscard]] std::vector<double> GetParams() const override;
+        [[nodiscard]] Mat2Xd RemoveDistoPoints(const Mat2Xd &p) const override;
 
         /**
-        * @brief Data wrapper for non linear optimization (update from data)
-        * @param paramsVec List of paramsVec used to update this intrinsic
-        * @retval true if update is correct
-        * @retval false if there was an error during update
+        * @brief Compute projections of 3D points (one per column) into the image plane, by the dispatched
+        * 'SimdKernels::projectRadial' kernel
+        * @param X 3D-points to project on image plane
+        * @param ignoreDisto whether the distortion is ignored
+        * @return Projected (2D) points on image plane
         */
-        bool UpdateFromParams(const std::vector<double> &paramsVec) override;
+        [[nodiscard]] Mat2Xd ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const override;
 
         /**
         * @brief Return the list of parameter indexes that must be held constant
@@ -291,8 +298,9 @@ namespace ns_veta {
         template<class Archive>
         inline void save(Archive &ar) const {
             PinholeIntrinsic::save(ar);
+            const std::vector<double> disto(params.cbegin() + 4, params.cbegin() + 4 + distoCount);
             ar(cereal::make_nvp("disto_param_note", std::string("k1, k2, k3")));
-            ar(cereal::make_nvp("disto_param", params));
+            ar(cereal::make_nvp("disto_param", disto));
         }
 
         /**
@@ -302,13 +310,16 @@ namespace ns_veta {
         template<class Archive>
         inline void load(Archive &ar) {
             PinholeIntrinsic::load(ar);
+            std::vector<double> disto;
             ar(cereal::make_nvp("disto_param_note", std::string("k1, k2, k3"))); //useless
-            ar(cereal::make_nvp("disto_param", params));
-            if (params.size() != 3) {
+            ar(cereal::make_nvp("disto_param", disto));
+            if (disto.size() != DistoCount) {
                 throw std::runtime_error(
                         "camera model 'pinhole_radial_k3' should maintain three distortion parameters (k1, k2, k3)"
                 );
             }
+            std::copy(disto.cbegin(), disto.cend(), params.begin() + 4);
+            distoCount = DistoCount;
         }
 
         /**
@@ -326,7 +337,7 @@ namespace ns_veta {
         * @param r2 square distance (relative to Center)
         * @return distance
         */
-        static double DistoFunctor(const std::vector<double> &params, double r2);
+        static double DistoFunctor(const double *params, double r2);
     };
 
 }
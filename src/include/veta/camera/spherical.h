@@ -53,6 +53,8 @@ namespace ns_veta {
         */
         bool UpdateFromParams(const std::vector<double> &params) override;
 
+        using IntrinsicBase::UpdateFromParams;
+
         /**
         * @brief Return the list of parameter indexes that must be held constant
         * @param parametrization The given parametrization
@@ -75,7 +77,8 @@ namespace ns_veta {
         [[nodiscard]] Vec2d ImgToCam(const Vec2d &p) const override;
 
         /**
-        * @brief Get bearing vectors from image coordinates
+        * @brief Get bearing vectors from image coordinates, computed by batches with 'FastMath::SinCos'.
+        * Large sets of points are processed in parallel
         * @return bearing vectors
         */
         Mat3Xd operator()(const Mat2Xd &points) const override;
@@ -88,6 +91,15 @@ namespace ns_veta {
         */
         [[nodiscard]] Vec2d Project(const Vec3d &X, bool ignoreDisto) const override;
 
+        /**
+        * @brief Compute projections of 3D points (one per column) into the image plane, computed by batches with
+        * 'FastMath::Atan2'
+        * @param X 3D-points to project on image plane
+        * @param ignoreDisto unused (spherical camera does not have distortion field)
+        * @return Projected (2D) points on image plane
+        */
+        [[nodiscard]] Mat2Xd ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const override;
+
         /**
         * @brief Does the camera model handle a distortion field?
         * @retval false
@@ -0,0 +1,101 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_CODEC_H
+#define VETA_CODEC_H
+
+#include "veta/type_def.hpp"
+
+namespace ns_veta {
+
+    /**
+    * @brief Append-only byte buffer with the primitive encoders used by the columnar format
+    */
+    class ByteWriter {
+    protected:
+        std::vector<uint8_t> buffer;
+
+    public:
+        ByteWriter() = default;
+
+        [[nodiscard]] const std::vector<uint8_t> &Buffer() const;
+
+        std::vector<uint8_t> &Buffer();
+
+        [[nodiscard]] std::size_t Size() const;
+
+        void Clear();
+
+        void PutByte(uint8_t v);
+
+        void PutBytes(const uint8_t *data, std::size_t size);
+
+        /**
+        * @brief write an unsigned integer using LEB128 (7 bits per byte)
+        */
+        void PutVarUInt(uint64_t v);
+
+        /**
+        * @brief write a signed integer as zig-zag encoded LEB128
+        */
+        void PutVarInt(int64_t v);
+    };
+
+    /**
+    * @brief Bounds checked reader over a byte range, throws 'std::runtime_error' on truncated input
+    */
+    class ByteReader {
+    protected:
+        const uint8_t *cur;
+        const uint8_t *end;
+
+    public:
+        ByteReader(const uint8_t *data, std::size_t size);
+
+        [[nodiscard]] bool AtEnd() const;
+
+        [[nodiscard]] std::size_t Remaining() const;
+
+        uint8_t GetByte();
+
+        const uint8_t *GetBytes(std::size_t size);
+
+        uint64_t GetVarUInt();
+
+        int64_t GetVarInt();
+    };
+
+    /**
+    * @brief encode a double column by xor-ing each value with its predecessor and dropping
+    * the leading and trailing zero bytes of the result (one control byte per value)
+    */
+    void PutXorDoubles(ByteWriter &writer, const double *values, std::size_t count);
+
+    void GetXorDoubles(ByteReader &reader, double *values, std::size_t count);
+
+    /**
+    * @brief Built-in LZ77 block codec (LZ4-like token stream, 64 KiB window), no external dependency
+    * @param data raw bytes
+    * @param size number of raw bytes
+    * @return compressed bytes
+    */
+    std::vector<uint8_t> LzCompress(const uint8_t *data, std::size_t size);
+
+    /**
+    * @brief decode a block produced by 'LzCompress'
+    * @param rawSize the number of raw bytes, known from the container
+    * @return raw bytes, throws 'std::runtime_error' on corrupted input
+    */
+    std::vector<uint8_t> LzDecompress(const uint8_t *data, std::size_t size, std::size_t rawSize);
+
+    /**
+    * @brief write a column as [raw size][codec][stored size][bytes], the column is LZ compressed
+    * only if this makes it smaller
+    */
+    void PutColumn(ByteWriter &writer, const std::vector<uint8_t> &column);
+
+    std::vector<uint8_t> GetColumn(ByteReader &reader);
+}
+
+#endif //VETA_CODEC_H
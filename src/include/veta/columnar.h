@@ -0,0 +1,56 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_COLUMNAR_H
+#define VETA_COLUMNAR_H
+
+#include "veta/veta.h"
+#include "veta/codec.h"
+
+namespace ns_veta {
+
+    /**
+    * @brief The '.vetac' format: views, intrinsics and extrinsics are stored by the portable binary
+    * cereal archive, the structure is split in blocks of landmarks, each block is stored column-wise:
+    *
+    *   landmark ids      delta encoded (sorted) varints
+    *   X, Y, Z           three xor-compressed double columns
+    *   color             run-length encoded rgb triplets
+    *   observation count varints
+    *   view ids          per-landmark delta encoded (sorted) varints
+    *   feature ids       zig-zag delta encoded varints
+    *   x, y              two xor-compressed double columns
+    *
+    * each column is then compressed by the built-in LZ codec (see 'LzCompress').
+    * The encoding is lossless.
+    */
+    struct ColumnarFormat {
+        // magic bytes at the beginning of a '.vetac' file
+        static constexpr char Magic[8] = {'V', 'E', 'T', 'A', 'C', 'O', 'L', '1'};
+
+        // number of landmarks per block
+        static constexpr std::size_t BlockSize = 1 << 16;
+    };
+
+    /**
+    * @brief encode landmarks of range [begin, end) to a columnar block
+    */
+    std::vector<uint8_t> EncodeLandmarkBlock(Landmarks::const_iterator begin, Landmarks::const_iterator end);
+
+    /**
+    * @brief decode a columnar block and insert its landmarks to 'structure'
+    */
+    void DecodeLandmarkBlock(const uint8_t *data, std::size_t size, Landmarks &structure);
+
+    /// Save a veta scene to the columnar '.vetac' format
+    bool SaveColumnar(const Veta &veta, const std::string &filename, Veta::Parts flag);
+
+    /**
+    * @brief Load a veta scene from the columnar '.vetac' format, the blocks of the structure are decoded in
+    * parallel (serially if the memory resource of the scene is not a synchronized 'ArenaResource' nor the heap)
+    */
+    bool LoadColumnar(Veta &veta, const std::string &filename, Veta::Parts flag);
+}
+
+#endif //VETA_COLUMNAR_H
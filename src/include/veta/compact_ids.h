@@ -0,0 +1,23 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_COMPACT_IDS_H
+#define VETA_COMPACT_IDS_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @brief Renumber the views, poses, intrinsics and landmarks of a scene to 0..n-1, keeping their order, and
+    * rewrite the references ('View::viewId', 'View::poseId', 'View::intrinsicId' and the observation keys) in
+    * parallel. The map nodes are moved rather than reallocated. References to missing elements become
+    * 'UndefinedIndexT', and the observations of missing views are dropped. Views shared with another scene are
+    * copied before they are rewritten.
+    * @return the new ids (indexed by the previous ones)
+    */
+    IdMap CompactIds(Veta &veta);
+}
+
+#endif //VETA_COMPACT_IDS_H
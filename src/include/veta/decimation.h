@@ -0,0 +1,44 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_DECIMATION_H
+#define VETA_DECIMATION_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    struct DecimationOptions {
+    public:
+        // edge length of the voxels, zero to search the one giving about 'targetLandmarks' occupied voxels
+        double voxelSize = 0.0;
+        // approximate number of kept landmarks (before the per-view completion), used if 'voxelSize' is zero
+        std::size_t targetLandmarks = 100000;
+        // relative tolerance of the voxel size search on the number of occupied voxels
+        double targetTolerance = 0.05;
+        // each view keeps at least this number of the landmarks it observes (or all of them if it observes
+        // fewer), zero to disable
+        std::size_t minLandmarksPerView = 0;
+    };
+
+    // Define a selection of landmarks: one flag per landmark, in the order of 'Veta::structure'
+    using LandmarkMask = std::vector<uint8_t>;
+
+    /**
+    * @brief Select a spatially uniform subset of the landmarks: the positions are voxel-hashed in parallel and each
+    * occupied voxel keeps its best-observed landmark (the most observations, then the closest to the voxel
+    * center). Then, if 'DecimationOptions::minLandmarksPerView', the views left with too few landmarks get back
+    * their best-observed ones, greedily. Landmarks with a non-finite position are dropped.
+    * @return the selection, in the order of 'Veta::structure'
+    */
+    LandmarkMask DecimationMask(const Veta &veta, const DecimationOptions &options = DecimationOptions());
+
+    /**
+    * @brief the scene with the landmarks selected by 'DecimationMask', the views, poses and intrinsics are kept
+    * (the view and intrinsic objects are shared, as when copying a 'Veta')
+    */
+    Veta Decimate(const Veta &veta, const DecimationOptions &options = DecimationOptions());
+}
+
+#endif //VETA_DECIMATION_H
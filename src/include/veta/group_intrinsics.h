@@ -0,0 +1,26 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_GROUP_INTRINSICS_H
+#define VETA_GROUP_INTRINSICS_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @brief Collapse the intrinsics of a scene describing the same camera, keeping the one with the smallest id of
+    * each group, and rewrite 'View::intrinsicId' in bulk. Intrinsics are bucketed by hash: by
+    * 'IntrinsicBase::HashValue' for an exact comparison, and by type, image size and parameter count otherwise,
+    * a group then gathering the parameters matching within the tolerance (sweep over sorted first parameters).
+    * Views shared with another scene are copied before they are rewritten.
+    * @param veta the scene
+    * @param tolerance the maximum difference of two matching parameters, relative to their magnitude above one
+    * (|a - b| <= tolerance * max(1, |a|, |b|)), zero for identical parameters
+    * @return the id of the kept intrinsic, indexed by the id of each collapsed one
+    */
+    HashMap<IndexT, IndexT> GroupIntrinsics(Veta &veta, double tolerance = 0.0);
+}
+
+#endif //VETA_GROUP_INTRINSICS_H
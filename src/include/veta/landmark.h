@@ -9,20 +9,87 @@
 #include "type_def.hpp"
 
 namespace ns_veta {
+
+    /**
+    * @brief storage of the observation members in memory
+    * @note by default pixels are kept as double and feature ids as 64-bit indexes, which is lossless.
+    * Defining 'VETA_COMPACT_OBSERVATION' (cmake option of the same name) stores pixels as float32 and
+    * feature ids as 32-bit indexes: for pixel coordinates below 2^14 (16384) the rounding error is
+    * bounded by 2^-11 (~4.9e-4) pixel, and feature ids must be lower than 2^32 - 1.
+    * @note the saving in memory is bounded by the map node of each observation ('Observations'): an
+    * 'Observation' shrinks from 32 to 12 bytes, but the node (tree links, key and observation) only from
+    * 80 to 56 bytes with libstdc++, about 30% of the observations, not half. Halving the observations
+    * is done on disk, by the 'FLOAT32' and 'FIXED_POINT' encodings of 'Save'.
+    * @attention the option changes the types of 'Observation::x' and 'Observation::featId', so that the
+    * library and its users must be compiled with the same definition (a public definition of the 'veta'
+    * target, exported to the users of the installed package)
+    */
+#ifdef VETA_COMPACT_OBSERVATION
+    using ObsPixel = Vec2f;
+    using ObsFeatIdT = uint32_t;
+#else
+    using ObsPixel = Vec2d;
+    using ObsFeatIdT = IndexT;
+#endif
+
+    // undefined feature index in the in-memory storage
+    static const ObsFeatIdT UndefinedObsFeatIdT = std::numeric_limits<ObsFeatIdT>::max();
+
+    /**
+    * @enum ObsEncoding encoding of the observations in the 'structure' part of a file
+    * @var DOUBLE
+    *   legacy layout: 64-bit feature id and two double pixels, lossless
+    * @var FLOAT32
+    *   32-bit feature id and two float32 pixels, for |x| < 2^14 the error is bounded by 2^-11 pixel
+    * @var FIXED_POINT
+    *   32-bit feature id and two int32 pixels in 1/256 pixel units, the error is bounded by 1/512 pixel
+    *   for any |x| < 2^23 pixel
+    */
+    enum class ObsEncoding : int {
+        DOUBLE = 0,
+        FLOAT32 = 1,
+        FIXED_POINT = 2
+    };
+
     // Define 3D-2D tracking data: 3D landmark with its 2D observations
     struct Observation {
     public:
-        Observation() : featId(UndefinedIndexT), x(Vec2d::Zero()) {}
+        Observation() : x(ObsPixel::Zero()), featId(UndefinedObsFeatIdT) {}
+
+        Observation(const Vec2d &p, IndexT idFeat)
+                : x(p.cast<ObsPixel::Scalar>()), featId(ToObsFeatId(idFeat)) {}
+
+        ObsPixel x;
+        ObsFeatIdT featId;
 
-        Observation(Vec2d p, IndexT idFeat) : x(std::move(p)), featId(idFeat) {}
+        /**
+        * @brief the feature id as a portable 64-bit index
+        * @return feature id ('UndefinedIndexT' if not defined)
+        */
+        [[nodiscard]] IndexT FeatId() const {
+            return featId == UndefinedObsFeatIdT ? UndefinedIndexT : static_cast<IndexT>(featId);
+        }
 
-        Vec2d x;
-        IndexT featId;
+        /**
+        * @brief narrow a portable 64-bit feature index to the in-memory storage
+        * @param idFeat the portable feature id
+        * @return feature id in the in-memory storage
+        */
+        static ObsFeatIdT ToObsFeatId(IndexT idFeat) {
+            if (idFeat == UndefinedIndexT) {
+                return UndefinedObsFeatIdT;
+            }
+            if (idFeat >= static_cast<IndexT>(UndefinedObsFeatIdT)) {
+                throw std::out_of_range("feature id '" + std::to_string(idFeat) +
+                                        "' can not be stored in the observation storage");
+            }
+            return static_cast<ObsFeatIdT>(idFeat);
+        }
 
         // Serialization
         template<class Archive>
         void save(Archive &ar) const {
-            ar(cereal::make_nvp("feat_id", featId));
+            ar(cereal::make_nvp("feat_id", FeatId()));
             const std::vector<double> pp{x(0), x(1)};
             ar(cereal::make_nvp("x", pp));
         }
@@ -30,10 +97,99 @@ namespace ns_veta {
         // Serialization
         template<class Archive>
         void load(Archive &ar) {
-            ar(cereal::make_nvp("feat_id", featId));
+            IndexT idFeat;
+            ar(cereal::make_nvp("feat_id", idFeat));
+            featId = ToObsFeatId(idFeat);
             std::vector<double> p(2);
             ar(cereal::make_nvp("x", p));
-            x = Eigen::Map<const Vec2d>(&p[0]);
+            x = Eigen::Map<const Vec2d>(&p[0]).cast<ObsPixel::Scalar>();
+        }
+    };
+
+    /**
+    * @brief serialize an observation using an explicit encoding (see 'ObsEncoding')
+    */
+    template<class ObservationType>
+    struct EncodedObservation {
+    public:
+        ObservationType &obs;
+        ObsEncoding encoding;
+
+        // 1/256 pixel per unit
+        static constexpr double FixedPointScale = 256.0;
+
+        template<class Archive>
+        void save(Archive &ar) const {
+            switch (encoding) {
+                case ObsEncoding::DOUBLE:
+                    obs.save(ar);
+                    break;
+                case ObsEncoding::FLOAT32: {
+                    const uint32_t idFeat = ToFeatId32(obs.FeatId());
+                    ar(cereal::make_nvp("feat_id", idFeat));
+                    const float px = static_cast<float>(obs.x(0)), py = static_cast<float>(obs.x(1));
+                    ar(cereal::make_nvp("x", px), cereal::make_nvp("y", py));
+                }
+                    break;
+                case ObsEncoding::FIXED_POINT: {
+                    const uint32_t idFeat = ToFeatId32(obs.FeatId());
+                    ar(cereal::make_nvp("feat_id", idFeat));
+                    const auto px = ToFixedPoint(obs.x(0)), py = ToFixedPoint(obs.x(1));
+                    ar(cereal::make_nvp("x", px), cereal::make_nvp("y", py));
+                }
+                    break;
+            }
+        }
+
+        template<class Archive>
+        void load(Archive &ar) {
+            switch (encoding) {
+                case ObsEncoding::DOUBLE:
+                    obs.load(ar);
+                    break;
+                case ObsEncoding::FLOAT32: {
+                    uint32_t idFeat;
+                    float px, py;
+                    ar(cereal::make_nvp("feat_id", idFeat));
+                    ar(cereal::make_nvp("x", px), cereal::make_nvp("y", py));
+                    obs.featId = FromFeatId32(idFeat);
+                    obs.x = Vec2f(px, py).cast<ObsPixel::Scalar>();
+                }
+                    break;
+                case ObsEncoding::FIXED_POINT: {
+                    uint32_t idFeat;
+                    int32_t px, py;
+                    ar(cereal::make_nvp("feat_id", idFeat));
+                    ar(cereal::make_nvp("x", px), cereal::make_nvp("y", py));
+                    obs.featId = FromFeatId32(idFeat);
+                    obs.x = Vec2d(px / FixedPointScale, py / FixedPointScale).cast<ObsPixel::Scalar>();
+                }
+                    break;
+            }
+        }
+
+        static uint32_t ToFeatId32(IndexT idFeat) {
+            if (idFeat == UndefinedIndexT) {
+                return std::numeric_limits<uint32_t>::max();
+            }
+            if (idFeat >= std::numeric_limits<uint32_t>::max()) {
+                throw cereal::Exception("feature id is out of the range of the 32-bit observation encoding");
+            }
+            return static_cast<uint32_t>(idFeat);
+        }
+
+        static ObsFeatIdT FromFeatId32(uint32_t idFeat) {
+            return idFeat == std::numeric_limits<uint32_t>::max() ? UndefinedObsFeatIdT
+                                                                   : static_cast<ObsFeatIdT>(idFeat);
+        }
+
+        static int32_t ToFixedPoint(double v) {
+            const double scaled = std::round(v * FixedPointScale);
+            // written as a negation so that NaN is rejected as well
+            if (!(std::abs(scaled) <= static_cast<double>(std::numeric_limits<int32_t>::max()))) {
+                throw cereal::Exception("pixel coordinate is not finite or out of the fixed-point range");
+            }
+            return static_cast<int32_t>(scaled);
         }
     };
 
@@ -78,6 +234,67 @@ namespace ns_veta {
             color = Eigen::Map<const Color>(&c[0]);
         }
     };
+
+    /**
+    * @brief serialize the observations of a landmark using an explicit encoding (see 'ObsEncoding')
+    */
+    template<class ObservationsType>
+    struct EncodedObservations {
+    public:
+        ObservationsType &obs;
+        ObsEncoding encoding;
+
+        template<class Archive>
+        void save(Archive &ar) const {
+            ar(cereal::make_size_tag(static_cast<cereal::size_type>(obs.size())));
+            for (const auto &[viewId, ob]: obs) {
+                ar(cereal::make_map_item(viewId, EncodedObservation<const Observation>{ob, encoding}));
+            }
+        }
+
+        template<class Archive>
+        void load(Archive &ar) {
+            cereal::size_type size;
+            ar(cereal::make_size_tag(size));
+            obs.clear();
+            for (cereal::size_type i = 0; i < size; ++i) {
+                IndexT viewId;
+                Observation ob;
+                ar(cereal::make_map_item(viewId, EncodedObservation<Observation>{ob, encoding}));
+                obs.emplace_hint(obs.end(), viewId, ob);
+            }
+        }
+    };
+
+    /**
+    * @brief serialize a landmark with its observations using an explicit encoding (see 'ObsEncoding')
+    */
+    template<class LandmarkType>
+    struct EncodedLandmark {
+    public:
+        LandmarkType &lm;
+        ObsEncoding encoding;
+
+        template<class Archive>
+        void save(Archive &ar) const {
+            const std::vector<double> point{lm.X(0), lm.X(1), lm.X(2)};
+            ar(cereal::make_nvp("X", point));
+            ar(cereal::make_nvp("observations", EncodedObservations<const Observations>{lm.obs, encoding}));
+            const std::vector<uint8_t> c{lm.color(0), lm.color(1), lm.color(2)};
+            ar(cereal::make_nvp("color", c));
+        }
+
+        template<class Archive>
+        void load(Archive &ar) {
+            std::vector<double> point(3);
+            ar(cereal::make_nvp("X", point));
+            lm.X = Eigen::Map<const Vec3d>(&point[0]);
+            ar(cereal::make_nvp("observations", EncodedObservations<Observations>{lm.obs, encoding}));
+            std::vector<uint8_t> c(3);
+            ar(cereal::make_nvp("color", c));
+            lm.color = Eigen::Map<const Landmark::Color>(&c[0]);
+        }
+    };
 }
 
 #endif //VETA_LANDMARK_H
@@ -0,0 +1,39 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_MERGE_H
+#define VETA_MERGE_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    struct MergeOptions {
+    public:
+        // share the intrinsics of the same type, size and parameters ('IntrinsicBase::HashValue')
+        bool dedupIntrinsics = true;
+        // views of different scenes with the same (defined) timestamp and intrinsic are the same view, the pose of
+        // the first scene is kept. No alignment is done: the scenes must share a frame
+        bool mergeViewsByTimestamp = false;
+        // landmarks observing the same feature ('Observation::featId') in the same merged view are the same
+        // landmark: their observations are merged, the position and color of the first one are kept. Landmarks
+        // of different scenes only share the views merged by 'mergeViewsByTimestamp', without it they are only
+        // deduplicated within their scene
+        bool dedupLandmarks = true;
+    };
+
+    /**
+    * @brief Merge scenes whose ids collide (e.g. reconstructed by chunks, each one numbering from zero).
+    * All the ids are remapped in bulk to consecutive ids (from zero, by scene then by id), the views refer to
+    * the new pose and intrinsic ids ('UndefinedIndexT' if missing in their scene), and the landmarks are
+    * remapped and deduplicated in parallel shards.
+    * @param scenes the scenes to merge
+    * @param idMaps if not null, the new ids of each scene
+    * @return the merged scene, the views are copies, the intrinsics are shared with the scenes
+    */
+    Veta MergeScenes(const std::vector<const Veta *> &scenes, const MergeOptions &options = MergeOptions(),
+                     std::vector<IdMap> *idMaps = nullptr);
+}
+
+#endif //VETA_MERGE_H
@@ -0,0 +1,99 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_POSE_BATCH_H
+#define VETA_POSE_BATCH_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @brief Poses packed into contiguous arrays (a column-major rotation matrix and a translation per pose), so
+    * that composing, inverting poses and transforming points run as tight parallel loops instead of walking the
+    * nodes of 'Poses'. Each packed pose keeps its pose id, to be written back into 'Veta::poses'.
+    */
+    class PoseBatch {
+    public:
+        using Ptr = std::shared_ptr<PoseBatch>;
+
+    protected:
+        // the pose id of each packed pose ('UndefinedIndexT' if none)
+        std::vector<IndexT> poseIds;
+        // column-major rotation matrices, 9 values per pose
+        std::vector<double> rotations;
+        // translations, 3 values per pose
+        std::vector<double> translations;
+
+    public:
+        PoseBatch() = default;
+
+        /**
+        * @brief pack the poses of 'poses' whose id is in 'ids' (in this order, missing ids are skipped), all poses
+        * if 'ids' is empty
+        */
+        explicit PoseBatch(const Poses &poses, const std::vector<IndexT> &ids = {});
+
+        static Ptr Create(const Poses &poses, const std::vector<IndexT> &ids = {});
+
+        void Reserve(std::size_t size);
+
+        void PushBack(const Posed &pose, IndexT poseId = UndefinedIndexT);
+
+        [[nodiscard]] std::size_t Size() const;
+
+        [[nodiscard]] const std::vector<IndexT> &PoseIds() const;
+
+        [[nodiscard]] const double *RotationsData() const;
+
+        [[nodiscard]] const double *TranslationsData() const;
+
+        [[nodiscard]] Eigen::Map<const Mat3d> Rotation(std::size_t i) const;
+
+        Eigen::Map<Mat3d> Rotation(std::size_t i);
+
+        [[nodiscard]] Eigen::Map<const Vec3d> Translation(std::size_t i) const;
+
+        Eigen::Map<Vec3d> Translation(std::size_t i);
+
+        /**
+        * @brief the i-th packed pose
+        */
+        [[nodiscard]] Posed At(std::size_t i) const;
+
+        /**
+        * @brief inverse of each pose, the pose ids are kept
+        */
+        [[nodiscard]] PoseBatch InverseAll() const;
+
+        /**
+        * @brief element-wise composition 'lhs[i] * rhs[i]'; a batch of a single pose is composed with every pose
+        * of the other one. The pose ids are the ones of the largest batch ('lhs' if of the same size).
+        * @throw std::invalid_argument if the sizes do not match
+        */
+        static PoseBatch ComposeAll(const PoseBatch &lhs, const PoseBatch &rhs);
+
+        /**
+        * @brief transform the points (one per column) by each pose
+        * @return the transformed points, one matrix per pose
+        */
+        [[nodiscard]] std::vector<Mat3Xd> TransformPoints(const Mat3Xd &X) const;
+
+        /**
+        * @brief write the packed poses into 'poses' under their pose ids (inserted if missing), the poses without
+        * an id are skipped. The rotations are converted through unit quaternions (no SVD), so that the small
+        * drift of composed rotation matrices is removed.
+        */
+        void WriteBack(Poses &poses) const;
+    };
+
+    /**
+    * @brief transform the points (one per column) into the frame of each view, by the pose of the view
+    * (world to camera, as for 'IntrinsicBase::GetProjectiveEquivalent')
+    * @return the transformed points, one matrix per view, empty for the views without a pose
+    */
+    std::vector<Mat3Xd> TransformPoints(const Veta &veta, const std::vector<IndexT> &viewIds, const Mat3Xd &X);
+}
+
+#endif //VETA_POSE_BATCH_H
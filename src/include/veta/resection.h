@@ -0,0 +1,69 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_RESECTION_H
+#define VETA_RESECTION_H
+
+#include "veta/veta.h"
+#include "veta/sub_scene.h"
+
+namespace ns_veta {
+
+    struct ResectionOptions {
+    public:
+        // maximum reprojection error (pixels) of an inlier
+        double maxReprojError = 4.0;
+        // RANSAC iterations, fewer when the inlier ratio allows reaching the confidence
+        std::size_t maxIterations = 1000;
+        double confidence = 0.999;
+        // a view with fewer inliers is not resected
+        std::size_t minInliers = 12;
+        // Gauss-Newton steps on the bearing errors of the inliers, zero to disable
+        int refineIterations = 5;
+        // seed of the random samples, 'ResectViews' combines it with the id of each view
+        uint64_t seed = 0;
+        // write the poses of the resected views ('View::poseId' must be defined)
+        bool writeBack = true;
+    };
+
+    /**
+    * @brief the pose of a resected view
+    */
+    struct ResectionResult {
+    public:
+        bool success = false;
+        // world to camera (as for 'GetProjectiveEquivalent')
+        Posed pose;
+        // 2D-3D correspondences, and the inliers of the pose
+        std::size_t correspondences = 0, inliers = 0;
+        // reprojection RMSE (pixels) of the inliers
+        double rmse = std::numeric_limits<double>::max();
+        std::size_t iterations = 0;
+    };
+
+    // Define the resection results (indexed by View::viewId)
+    using ResectionReport = HashMap<IndexT, ResectionResult>;
+
+    /**
+    * @brief Estimate a pose from 2D-3D correspondences: minimal P3P (Grunert) on unprojected bearings inside RANSAC,
+    * each hypothesis scored on all the correspondences by the vectorized residuals of the intrinsic
+    * ('IntrinsicBase::Residuals'), then refined on its inliers
+    * @param X the 3D points, one per column
+    * @param x their observations (pixels), one per column
+    */
+    ResectionResult Resect(const IntrinsicBase &intrinsic, const Mat3Xd &X, const Mat2Xd &x,
+                           const ResectionOptions &options = ResectionOptions());
+
+    /**
+    * @brief Resect a batch of views in parallel against the structure. The correspondences of a view are the
+    * observations, in this view, of the given landmarks (e.g. by 'BuildViewLandmarks').
+    * @param viewLandmarks the landmarks observed by each view to resect
+    * @return the result of each view (with an intrinsic), the poses of the successful ones are written into
+    * 'Veta::poses' if 'ResectionOptions::writeBack'
+    */
+    ResectionReport ResectViews(Veta &veta, const ViewLandmarks &viewLandmarks,
+                                const ResectionOptions &options = ResectionOptions());
+}
+
+#endif //VETA_RESECTION_H
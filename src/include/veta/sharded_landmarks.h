@@ -0,0 +1,155 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_SHARDED_LANDMARKS_H
+#define VETA_SHARDED_LANDMARKS_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @enum ShardPolicy how the landmarks are dispatched to the shards
+    * @var ID_RANGE
+    *   contiguous id ranges, balanced on the ids at partition time (see 'ShardedLandmarks::Rebalance')
+    * @var HASH
+    *   hash of the id, balanced for any id distribution
+    */
+    enum class ShardPolicy : int {
+        ID_RANGE = 0,
+        HASH = 1
+    };
+
+    /**
+    * @brief Landmarks partitioned into independent shards, so that scene-wide passes run one shard per worker
+    * without locking. The partition moves the map nodes (no copy, no allocation), and so does the conversion back.
+    */
+    class ShardedLandmarks {
+    public:
+        using Ptr = std::shared_ptr<ShardedLandmarks>;
+
+    protected:
+        ShardPolicy policy;
+        std::vector<Landmarks> shards;
+        // ID_RANGE: the first id of each shard (the first one is zero)
+        std::vector<IndexT> bounds;
+
+    public:
+        /**
+        * @param shardCount the number of shards, zero for 'HardwareThreads()'
+        */
+        explicit ShardedLandmarks(std::size_t shardCount = 0, ShardPolicy policy = ShardPolicy::ID_RANGE);
+
+        static Ptr Create(std::size_t shardCount = 0, ShardPolicy policy = ShardPolicy::ID_RANGE);
+
+        /**
+        * @brief partition the landmarks, which are moved into the shards
+        */
+        static ShardedLandmarks Partition(Landmarks &&structure, std::size_t shardCount = 0,
+                                          ShardPolicy policy = ShardPolicy::ID_RANGE);
+
+        /**
+        * @brief move the landmarks back into a single map, the shards are left empty
+        */
+        Landmarks Join();
+
+        /**
+        * @brief ID_RANGE: rebalance the id ranges on the current ids (e.g. after inserting past the last range)
+        */
+        void Rebalance();
+
+        [[nodiscard]] ShardPolicy Policy() const;
+
+        [[nodiscard]] std::size_t ShardCount() const;
+
+        [[nodiscard]] std::size_t Size() const;
+
+        [[nodiscard]] std::size_t ShardOf(IndexT lmId) const;
+
+        [[nodiscard]] const Landmarks &Shard(std::size_t s) const;
+
+        Landmarks &Shard(std::size_t s);
+
+        /**
+        * @return the landmark, nullptr if missing
+        */
+        [[nodiscard]] const Landmark *Find(IndexT lmId) const;
+
+        Landmark *Find(IndexT lmId);
+
+        /**
+        * @brief insert the landmark, or overwrite the one of the same id
+        */
+        Landmark &Insert(IndexT lmId, Landmark lm);
+
+        bool Erase(IndexT lmId);
+
+        /**
+        * @brief run 'func(shardIdx, shard)' on each shard in parallel, one shard per worker
+        */
+        template<typename Func>
+        void ForEachShard(Func &&func) {
+            ParallelFor(0, shards.size(), [this, &func](std::size_t s) { func(s, shards[s]); }, 1);
+        }
+
+        template<typename Func>
+        void ForEachShard(Func &&func) const {
+            ParallelFor(0, shards.size(), [this, &func](std::size_t s) { func(s, shards[s]); }, 1);
+        }
+
+        /**
+        * @brief run 'func(lmId, lm)' on each landmark in parallel, the landmarks of a shard by increasing id on the
+        * same worker
+        */
+        template<typename Func>
+        void ForEachLandmark(Func &&func) {
+            ForEachShard([&func](std::size_t, Landmarks &shard) {
+                for (auto &[lmId, lm]: shard) {
+                    func(lmId, lm);
+                }
+            });
+        }
+
+        template<typename Func>
+        void ForEachLandmark(Func &&func) const {
+            ForEachShard([&func](std::size_t, const Landmarks &shard) {
+                for (const auto &[lmId, lm]: shard) {
+                    func(lmId, lm);
+                }
+            });
+        }
+
+        /**
+        * @brief erase the landmarks for which 'pred(lmId, lm)' is true, in parallel
+        * @return the number of erased landmarks
+        */
+        template<typename Pred>
+        std::size_t EraseIf(Pred &&pred) {
+            std::vector<std::size_t> erased(shards.size(), 0);
+            ForEachShard([&pred, &erased](std::size_t s, Landmarks &shard) {
+                for (auto iter = shard.begin(); iter != shard.end();) {
+                    if (pred(iter->first, iter->second)) {
+                        iter = shard.erase(iter);
+                        ++erased[s];
+                    } else {
+                        ++iter;
+                    }
+                }
+            });
+            std::size_t count = 0;
+            for (const std::size_t c: erased) {
+                count += c;
+            }
+            return count;
+        }
+
+    protected:
+        /**
+        * @brief move the landmarks into the shards, the shards must be empty
+        */
+        void Distribute(Landmarks &&structure);
+    };
+}
+
+#endif //VETA_SHARDED_LANDMARKS_H
@@ -0,0 +1,135 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_SIMD_H
+#define VETA_SIMD_H
+
+#include <cstddef>
+#include <string>
+
+namespace ns_veta {
+
+    /**
+    * @brief Instruction set variants the batched kernels are compiled for
+    */
+    enum class SimdLevel : int {
+        SCALAR = 0,
+        AVX2 = 1,   // AVX2 + FMA
+        AVX512 = 2  // AVX-512F
+    };
+
+    /**
+    * @brief Table of the hot batched kernels of one instruction set variant. Points are packed column-major
+    * (x0, y0, z0, x1, ...), as in 'Mat3Xd' and 'Mat2Xd'.
+    */
+    struct SimdKernels {
+    public:
+        SimdLevel level;
+
+        const char *name;
+
+        /**
+        * @brief Y = R * X + t for 'n' points, 'R' is a column-major 3x3 matrix, 'X' and 'Y' may be the same array
+        */
+        void (*transformPoints)(const double *R, const double *t, const double *X, double *Y, std::size_t n);
+
+        /**
+        * @brief Pinhole projection of 'n' camera frame points with a radial distortion:
+        * x = f * p * (1 + k1 * r^2 + ... + kN * r^2N) + c with p = (X / Z, Y / Z)
+        * @param params fx, fy, cx, cy, k1, ..., kN (see 'PinholeIntrinsic::ParamsAddress()')
+        * @param distoCount the number N of radial coefficients
+        */
+        void (*projectRadial)(const double *params, std::size_t distoCount,
+                              const double *X, double *x, std::size_t n);
+
+        /**
+        * @brief Pinhole projection of 'n' camera frame points with a Brown-Conrady distortion (see
+        * 'PinholeIntrinsicBrownT2::AddDisto')
+        * @param params fx, fy, cx, cy, k1, k2, k3, t1, t2
+        */
+        void (*projectBrown)(const double *params, const double *X, double *x, std::size_t n);
+
+        /**
+        * @brief Pinhole projection of 'n' camera frame points with a fisheye distortion (see
+        * 'PinholeIntrinsicFisheye::AddDisto')
+        * @param params fx, fy, cx, cy, k1, k2, k3, k4
+        */
+        void (*projectFisheye)(const double *params, const double *X, double *x, std::size_t n);
+
+        /**
+        * @brief Remove a radial distortion from 'n' normalized image points (Newton iterations on the radius)
+        * @param disto k1, ..., kN
+        * @param converged set to zero for the points whose iterations did not converge (to be solved otherwise)
+        */
+        void (*removeRadialDisto)(const double *disto, std::size_t distoCount, const double *p, double *u,
+                                  unsigned char *converged, std::size_t n);
+
+        /**
+        * @brief Remove a Brown-Conrady distortion from 'n' normalized image points (Newton iterations)
+        * @param disto k1, k2, k3, t1, t2
+        * @param converged set to zero for the points whose iterations did not converge (to be solved otherwise)
+        */
+        void (*removeBrownDisto)(const double *disto, const double *p, double *u, unsigned char *converged,
+                                 std::size_t n);
+
+        /**
+        * @brief Remove a fisheye distortion from 'n' normalized image points (fixed point iterations on the angle)
+        * @param disto k1, k2, k3, k4
+        */
+        void (*removeFisheyeDisto)(const double *disto, const double *p, double *u, std::size_t n);
+
+        /**
+        * @brief r = x - r for 'n' 2D points: the residuals of the observations 'x' given their projections 'r'
+        */
+        void (*residuals)(const double *x, double *r, std::size_t n);
+
+        /**
+        * @brief sin and cos of 'n' values (see 'FastMath::SinCos')
+        */
+        void (*sinCos)(const double *x, double *sin, double *cos, std::size_t n);
+
+        /**
+        * @brief atan2 of 'n' pairs of values (see 'FastMath::Atan2')
+        */
+        void (*atan2)(const double *y, const double *x, double *a, std::size_t n);
+    };
+
+    /**
+    * @brief Runtime selection (by CPUID) of the kernel variant, so that a single binary uses the widest
+    * instruction set supported by the running CPU, with a scalar fallback
+    */
+    class SimdDispatch {
+    public:
+        /**
+        * @brief the kernels of the selected variant, detected at the first call
+        */
+        static const SimdKernels &Kernels();
+
+        /**
+        * @brief the selected variant
+        */
+        static SimdLevel Level();
+
+        /**
+        * @brief name of the selected variant: "scalar", "avx2" or "avx512"
+        */
+        static std::string Name();
+
+        /**
+        * @brief whether a variant is compiled in this library and supported by the running CPU
+        */
+        static bool Supported(SimdLevel level);
+
+        /**
+        * @brief force a variant (e.g. to compare the variants or to rule one out)
+        * @retval false if the variant is not supported, the selection is then unchanged
+        */
+        static bool Select(SimdLevel level);
+
+    protected:
+        static const SimdKernels *Find(SimdLevel level);
+    };
+}
+
+#endif //VETA_SIMD_H
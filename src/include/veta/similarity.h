@@ -0,0 +1,30 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_SIMILARITY_H
+#define VETA_SIMILARITY_H
+
+#include "veta/veta.h"
+#include "sophus/sim3.hpp"
+
+namespace ns_veta {
+
+    /**
+    * @brief Move a whole scene by a similarity (e.g. georegistration): each landmark becomes
+    * X' = s * R * X + t, and each pose (world to camera) is updated so that the landmarks keep their image
+    * projections, the camera frame being scaled by 's'. Poses and landmarks are updated in parallel, the
+    * landmarks by batches through the dispatched point transform kernel. The rotations of the poses are composed
+    * as quaternions, with no 'AdjustRotationMatrix'.
+    * @param veta the scene to update in place
+    * @param sim the similarity from the current world frame to the new one
+    */
+    void ApplySimilarity(Veta &veta, const Sophus::Sim3d &sim);
+
+    /**
+    * @brief the pose (world to camera) of a camera after its world frame is moved by a similarity
+    */
+    Posed TransformPose(const Posed &worldToCam, const Sophus::Sim3d &sim);
+}
+
+#endif //VETA_SIMILARITY_H
@@ -0,0 +1,324 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_SNAPSHOT_H
+#define VETA_SNAPSHOT_H
+
+#include "veta/veta.h"
+#include <atomic>
+
+namespace ns_veta {
+
+    /**
+    * @brief An ordered map with structural sharing: the items are stored in sorted chunks of bounded size, shared
+    * between the copies of the map. Copying a map is O(1), and a write copies the chunk it touches (and the chunk
+    * list) only if they are shared with another copy.
+    * @note a map is not thread-safe, but its copies can be used from different threads: the shared chunks are
+    * never modified
+    */
+    template<typename Key, typename Value>
+    class CowMap {
+    public:
+        using Item = std::pair<Key, Value>;
+
+        static constexpr std::size_t DefaultChunkCapacity = 256;
+
+    protected:
+        struct Chunk {
+        public:
+            // sorted by key, never empty
+            std::vector<Item> items;
+        };
+
+        struct Root {
+        public:
+            std::vector<std::shared_ptr<Chunk>> chunks;
+            std::size_t size = 0;
+        };
+
+        std::shared_ptr<Root> root;
+        std::size_t chunkCapacity;
+
+    public:
+        explicit CowMap(std::size_t chunkCapacity = DefaultChunkCapacity)
+                : root(std::make_shared<Root>()), chunkCapacity(std::max<std::size_t>(chunkCapacity, 2)) {}
+
+        /**
+        * @brief build the map from the items of an ordered map
+        */
+        template<typename MapType>
+        static CowMap FromMap(const MapType &map, std::size_t chunkCapacity = DefaultChunkCapacity) {
+            CowMap result(chunkCapacity);
+            for (const auto &[key, value]: map) {
+                result.Insert(key, value);
+            }
+            return result;
+        }
+
+        [[nodiscard]] std::size_t Size() const {
+            return root->size;
+        }
+
+        [[nodiscard]] bool Empty() const {
+            return root->size == 0;
+        }
+
+        [[nodiscard]] std::size_t ChunkCount() const {
+            return root->chunks.size();
+        }
+
+        /**
+        * @return the value, nullptr if missing
+        */
+        [[nodiscard]] const Value *Find(const Key &key) const {
+            const std::size_t c = ChunkOf(key);
+            if (c == root->chunks.size()) {
+                return nullptr;
+            }
+            const auto &items = root->chunks[c]->items;
+            auto iter = LowerBound(items, key);
+            return iter != items.cend() && iter->first == key ? &iter->second : nullptr;
+        }
+
+        [[nodiscard]] bool Contains(const Key &key) const {
+            return Find(key) != nullptr;
+        }
+
+        /**
+        * @brief the value, throws 'std::out_of_range' if missing (as 'std::map::at')
+        */
+        [[nodiscard]] const Value &At(const Key &key) const {
+            const Value *value = Find(key);
+            if (value == nullptr) {
+                throw std::out_of_range("the key is not in the map");
+            }
+            return *value;
+        }
+
+        /**
+        * @brief the value to modify, its chunk is copied if shared, nullptr if missing
+        */
+        Value *Mutable(const Key &key) {
+            const std::size_t c = ChunkOf(key);
+            if (c == root->chunks.size()) {
+                return nullptr;
+            }
+            const auto &items = root->chunks[c]->items;
+            auto iter = LowerBound(items, key);
+            if (iter == items.cend() || iter->first != key) {
+                return nullptr;
+            }
+            const std::size_t i = iter - items.cbegin();
+            return &MutableChunk(MutableRoot(), c).items[i].second;
+        }
+
+        /**
+        * @brief insert the value of the key, or overwrite it
+        */
+        void Insert(const Key &key, Value value) {
+            Root &r = MutableRoot();
+            std::size_t c = 0;
+            if (r.chunks.empty()) {
+                r.chunks.push_back(std::make_shared<Chunk>());
+                r.chunks.back()->items.reserve(chunkCapacity);
+            } else if ((c = ChunkOf(key)) == r.chunks.size()) {
+                // after the last key
+                --c;
+                if (r.chunks[c]->items.size() >= chunkCapacity) {
+                    // a new chunk, so that items inserted by increasing keys fill the chunks
+                    r.chunks.push_back(std::make_shared<Chunk>());
+                    r.chunks.back()->items.reserve(chunkCapacity);
+                    ++c;
+                }
+            }
+            auto &items = MutableChunk(r, c).items;
+            auto iter = LowerBound(items, key);
+            if (iter != items.end() && iter->first == key) {
+                iter->second = std::move(value);
+                return;
+            }
+            items.insert(iter, Item(key, std::move(value)));
+            ++r.size;
+            if (items.size() > chunkCapacity) {
+                // split in halves
+                auto upper = std::make_shared<Chunk>();
+                upper->items.reserve(chunkCapacity);
+                const std::size_t half = items.size() / 2;
+                std::move(items.begin() + half, items.end(), std::back_inserter(upper->items));
+                items.erase(items.begin() + half, items.end());
+                r.chunks.insert(r.chunks.begin() + c + 1, std::move(upper));
+            }
+        }
+
+        /**
+        * @retval false if the key is missing
+        */
+        bool Erase(const Key &key) {
+            const std::size_t c = ChunkOf(key);
+            if (c == root->chunks.size()) {
+                return false;
+            }
+            const auto &constItems = root->chunks[c]->items;
+            auto constIter = LowerBound(constItems, key);
+            if (constIter == constItems.cend() || constIter->first != key) {
+                return false;
+            }
+            const std::size_t i = constIter - constItems.cbegin();
+            Root &r = MutableRoot();
+            auto &items = MutableChunk(r, c).items;
+            items.erase(items.begin() + i);
+            --r.size;
+            if (items.empty()) {
+                r.chunks.erase(r.chunks.begin() + c);
+            }
+            return true;
+        }
+
+        void Clear() {
+            root = std::make_shared<Root>();
+        }
+
+        /**
+        * @brief visit the items by increasing key: 'func(key, value)'
+        */
+        template<typename Func>
+        void ForEach(Func &&func) const {
+            for (const auto &chunk: root->chunks) {
+                for (const auto &[key, value]: chunk->items) {
+                    func(key, value);
+                }
+            }
+        }
+
+        /**
+        * @brief copy the items into an ordered map
+        */
+        template<typename MapType>
+        [[nodiscard]] MapType ToMap() const {
+            MapType map;
+            ForEach([&map](const Key &key, const Value &value) {
+                map.emplace_hint(map.end(), key, value);
+            });
+            return map;
+        }
+
+    protected:
+        static auto LowerBound(const std::vector<Item> &items, const Key &key) {
+            return std::lower_bound(items.cbegin(), items.cend(), key, [](const Item &item, const Key &k) {
+                return item.first < k;
+            });
+        }
+
+        static auto LowerBound(std::vector<Item> &items, const Key &key) {
+            return std::lower_bound(items.begin(), items.end(), key, [](const Item &item, const Key &k) {
+                return item.first < k;
+            });
+        }
+
+        /**
+        * @return the chunk which holds (or would hold) the key, the chunk count if the key is after the last key
+        */
+        [[nodiscard]] std::size_t ChunkOf(const Key &key) const {
+            const auto &chunks = root->chunks;
+            // the first chunk whose last key is not less than the key
+            auto iter = std::lower_bound(chunks.cbegin(), chunks.cend(), key,
+                                         [](const std::shared_ptr<Chunk> &chunk, const Key &k) {
+                                             return chunk->items.back().first < k;
+                                         });
+            return iter - chunks.cbegin();
+        }
+
+        // a block referenced only by this map can be modified, the other references are held by copies of the map
+        // (possibly on other threads), which can only release them: the fence orders their last reads before the
+        // writes of this map
+        template<typename Type>
+        static Type &Unshare(std::shared_ptr<Type> &ptr) {
+            if (ptr.use_count() > 1) {
+                ptr = std::make_shared<Type>(*ptr);
+            } else {
+                std::atomic_thread_fence(std::memory_order_acquire);
+            }
+            return *ptr;
+        }
+
+        Root &MutableRoot() {
+            return Unshare(root);
+        }
+
+        Chunk &MutableChunk(Root &r, std::size_t c) {
+            return Unshare(r.chunks[c]);
+        }
+    };
+
+    /**
+    * @brief an immutable version of a scene, its copies are O(1)
+    */
+    struct VetaVersion {
+    public:
+        using Ptr = std::shared_ptr<const VetaVersion>;
+
+        CowMap<IndexT, std::shared_ptr<const View>> views;
+        CowMap<IndexT, Posed> poses;
+        CowMap<IndexT, std::shared_ptr<const IntrinsicBase>> intrinsics;
+        CowMap<IndexT, Landmark> structure;
+
+        // incremented by each publication
+        std::size_t version = 0;
+
+        VetaVersion() = default;
+
+        /**
+        * @brief a version holding copies of the views and intrinsics of the scene
+        */
+        explicit VetaVersion(const Veta &veta);
+
+        /**
+        * @brief a scene holding copies of the views and intrinsics of this version
+        */
+        [[nodiscard]] Veta Materialize() const;
+    };
+
+    /**
+    * @brief A scene with a single writer and concurrent readers. The writer modifies the working version (a view or
+    * an intrinsic is modified by replacing its pointer), and publishes it in O(1); the readers take the last
+    * published version, which is immutable. Writes after a publication copy only the chunks they touch.
+    */
+    class SharedVeta {
+    public:
+        using Ptr = std::shared_ptr<SharedVeta>;
+
+    protected:
+        // only used by the writer
+        VetaVersion working;
+        // read and written atomically
+        VetaVersion::Ptr published;
+
+    public:
+        SharedVeta();
+
+        explicit SharedVeta(const Veta &veta);
+
+        static Ptr Create(const Veta &veta = Veta());
+
+        /**
+        * @brief the working version, only for the writer
+        */
+        VetaVersion &Working();
+
+        [[nodiscard]] const VetaVersion &Working() const;
+
+        /**
+        * @brief publish the working version to the readers, O(1), only for the writer
+        * @return the published version
+        */
+        VetaVersion::Ptr Publish();
+
+        /**
+        * @brief the last published version, O(1), thread-safe
+        */
+        [[nodiscard]] VetaVersion::Ptr Snapshot() const;
+    };
+}
+
+#endif //VETA_SNAPSHOT_H
@@ -0,0 +1,245 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_SPATIAL_INDEX_H
+#define VETA_SPATIAL_INDEX_H
+
+#include "veta/veta.h"
+#include "unordered_map"
+#include "array"
+
+namespace ns_veta {
+
+    /**
+    * @brief Axis aligned bounding box
+    */
+    struct AABB {
+    public:
+        Vec3d min;
+        Vec3d max;
+
+        AABB() : min(Vec3d::Constant(std::numeric_limits<double>::max())),
+                 max(Vec3d::Constant(std::numeric_limits<double>::lowest())) {}
+
+        AABB(Vec3d min, Vec3d max) : min(std::move(min)), max(std::move(max)) {}
+
+        void Extend(const Vec3d &p) {
+            min = min.cwiseMin(p);
+            max = max.cwiseMax(p);
+        }
+
+        void Extend(const AABB &box) {
+            min = min.cwiseMin(box.min);
+            max = max.cwiseMax(box.max);
+        }
+
+        [[nodiscard]] bool Contains(const Vec3d &p) const {
+            return (p.array() >= min.array()).all() && (p.array() <= max.array()).all();
+        }
+
+        [[nodiscard]] bool Contains(const AABB &box) const {
+            return (box.min.array() >= min.array()).all() && (box.max.array() <= max.array()).all();
+        }
+
+        [[nodiscard]] bool Intersects(const AABB &box) const {
+            return (box.max.array() >= min.array()).all() && (box.min.array() <= max.array()).all();
+        }
+
+        /**
+        * @brief squared distance from a point to the box (zero if inside)
+        */
+        [[nodiscard]] double SquaredDistance(const Vec3d &p) const {
+            return (min - p).cwiseMax(p - max).cwiseMax(0.0).squaredNorm();
+        }
+    };
+
+    /**
+    * @brief A convex volume bounded by planes, a point X is inside if 'n.dot(X) + d >= 0' for every plane (n, d)
+    */
+    struct Frustum {
+    public:
+        // near, far, left, right, top, bottom, stored as (n, d)
+        std::array<Vec4d, 6> planes;
+
+        enum Classification : int {
+            OUTSIDE = 0, INTERSECT = 1, INSIDE = 2
+        };
+
+        /**
+        * @brief build the frustum of a view
+        * @param worldToCam the pose mapping world points to the camera frame (as for 'GetProjectiveEquivalent')
+        * @param intrinsic the intrinsic of the view, the image border is unprojected to bound the field of view
+        * @param nearDist the distance of the near plane along the optical axis
+        * @param farDist the distance of the far plane along the optical axis
+        * @note meaningful for pinhole models only (the field of view must be smaller than 180 degrees)
+        */
+        static Frustum FromView(const Posed &worldToCam, const IntrinsicBase &intrinsic,
+                                double nearDist = 1E-3, double farDist = std::numeric_limits<double>::max());
+
+        /**
+        * @brief build the frustum of a view whose image size differs from the one of its intrinsic
+        * (e.g. 'View::imgWidth', 'View::imgHeight'), see the overload above
+        */
+        static Frustum FromView(const Posed &worldToCam, const IntrinsicBase &intrinsic, double width, double height,
+                                double nearDist = 1E-3, double farDist = std::numeric_limits<double>::max());
+
+        [[nodiscard]] bool Contains(const Vec3d &p) const;
+
+        [[nodiscard]] Classification Classify(const AABB &box) const;
+    };
+
+    /**
+    * @brief A static k-d tree over 'Landmark::X' (median splits, nodes keep tight bounding boxes).
+    * Queries only rely on the node bounding boxes, so moved landmarks can be handled by 'Refit' (after a bundle
+    * adjustment) or 'Update' (a few landmarks) without rebuilding the topology. Landmarks inserted after the
+    * build are kept in a linearly scanned list until the next 'Build'.
+    * @note queries are thread safe, modifications are not
+    */
+    class LandmarkKdTree {
+    public:
+        using Ptr = std::shared_ptr<LandmarkKdTree>;
+
+        // id and squared distance of a neighbor
+        using Neighbor = std::pair<IndexT, double>;
+
+    protected:
+        struct Node {
+            AABB box;
+            // range of the points of this node in the tree order
+            uint32_t begin, end;
+            // children ('-1' for leaves) and parent ('-1' for the root)
+            int32_t left, right, parent;
+        };
+
+        std::vector<Node> nodes;
+        // points, ids and erased flags in the tree order
+        std::vector<Vec3d> points;
+        std::vector<IndexT> ids;
+        std::vector<uint8_t> erased;
+        // landmark id to the index in the tree order
+        std::unordered_map<IndexT, std::size_t> slots;
+        // leaf owning each point (in the tree order)
+        std::vector<int32_t> leafOf;
+
+        // landmarks inserted after the build
+        std::vector<Vec3d> pendingPoints;
+        std::vector<IndexT> pendingIds;
+        std::unordered_map<IndexT, std::size_t> pendingSlots;
+
+        std::size_t leafSize;
+        std::size_t erasedCount;
+
+    public:
+        explicit LandmarkKdTree(std::size_t leafSize = 16);
+
+        explicit LandmarkKdTree(const Landmarks &structure, std::size_t leafSize = 16);
+
+        static Ptr Create(const Landmarks &structure, std::size_t leafSize = 16);
+
+        /**
+        * @brief (re)build the tree over the whole structure, in parallel
+        */
+        void Build(const Landmarks &structure);
+
+        /**
+        * @brief reload the positions of all indexed landmarks and refit the bounding boxes, the tree topology
+        * is kept (cheap, but queries slow down if the landmarks moved a lot: rebuild in that case)
+        */
+        void Refit(const Landmarks &structure);
+
+        /**
+        * @brief move an indexed landmark, the bounding boxes on its path to the root are enlarged
+        * @retval false if the landmark is not indexed
+        */
+        bool Update(IndexT lmId, const Vec3d &X);
+
+        /**
+        * @brief index a new landmark (or move an existing one)
+        */
+        void Insert(IndexT lmId, const Vec3d &X);
+
+        /**
+        * @brief remove a landmark from the index
+        * @retval false if the landmark is not indexed
+        */
+        bool Erase(IndexT lmId);
+
+        /**
+        * @brief whether inserted or erased landmarks make up a significant part of the index,
+        * so that 'Build' should be called
+        */
+        [[nodiscard]] bool NeedRebuild() const;
+
+        [[nodiscard]] std::size_t Size() const;
+
+        /**
+        * @brief landmarks lying within 'radius' of 'center'
+        */
+        [[nodiscard]] std::vector<IndexT> RadiusSearch(const Vec3d &center, double radius) const;
+
+        /**
+        * @brief the 'k' nearest landmarks of 'center', sorted by increasing squared distance
+        */
+        [[nodiscard]] std::vector<Neighbor> KNearest(const Vec3d &center, std::size_t k) const;
+
+        /**
+        * @brief landmarks lying inside the box
+        */
+        [[nodiscard]] std::vector<IndexT> BoxSearch(const AABB &box) const;
+
+        /**
+        * @brief landmarks lying inside the frustum
+        */
+        [[nodiscard]] std::vector<IndexT> FrustumSearch(const Frustum &frustum) const;
+
+        /**
+        * @brief visit the landmarks whose node boxes are accepted by 'nodeTest', and that pass 'pointTest'
+        * @param nodeTest 'Frustum::Classification(const AABB &)'
+        * @param pointTest 'bool(const Vec3d &)', skipped for nodes fully inside
+        * @param visitor 'void(IndexT, const Vec3d &)'
+        */
+        template<class NodeTest, class PointTest, class Visitor>
+        void Traverse(NodeTest &&nodeTest, PointTest &&pointTest, Visitor &&visitor) const {
+            if (!nodes.empty()) {
+                TraverseNode(0, nodeTest, pointTest, visitor);
+            }
+            for (std::size_t i = 0; i < pendingPoints.size(); ++i) {
+                if (pointTest(pendingPoints[i])) {
+                    visitor(pendingIds[i], pendingPoints[i]);
+                }
+            }
+        }
+
+    protected:
+        template<class NodeTest, class PointTest, class Visitor>
+        void TraverseNode(int32_t idx, NodeTest &nodeTest, PointTest &pointTest, Visitor &visitor) const {
+            const Node &node = nodes[idx];
+            const auto cls = nodeTest(node.box);
+            if (cls == Frustum::OUTSIDE) {
+                return;
+            }
+            if (cls == Frustum::INSIDE || node.left < 0) {
+                for (uint32_t i = node.begin; i < node.end; ++i) {
+                    if (!erased[i] && (cls == Frustum::INSIDE || pointTest(points[i]))) {
+                        visitor(ids[i], points[i]);
+                    }
+                }
+                return;
+            }
+            TraverseNode(node.left, nodeTest, pointTest, visitor);
+            TraverseNode(node.right, nodeTest, pointTest, visitor);
+        }
+
+        static std::size_t CountNodes(std::size_t count, std::size_t leafSize);
+
+        void BuildNode(int32_t idx, int32_t parent, uint32_t begin, uint32_t end,
+                       std::vector<uint32_t> &order, std::size_t parallelDepth);
+
+        void RefitNode(int32_t idx);
+
+        void KNearestNode(int32_t idx, const Vec3d &center, std::size_t k, std::vector<Neighbor> &heap) const;
+    };
+}
+
+#endif //VETA_SPATIAL_INDEX_H
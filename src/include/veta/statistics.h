@@ -0,0 +1,176 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_STATISTICS_H
+#define VETA_STATISTICS_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @brief count, mean, standard deviation and range of a sample, mergeable
+    */
+    struct RunningStats {
+    public:
+        std::size_t count = 0;
+        double sum = 0.0, sumSq = 0.0;
+        double min = std::numeric_limits<double>::max(), max = std::numeric_limits<double>::lowest();
+
+        void Add(double value);
+
+        void Merge(const RunningStats &other);
+
+        [[nodiscard]] double Mean() const;
+
+        [[nodiscard]] double StdDev() const;
+
+        template<class Archive>
+        void save(Archive &ar) const {
+            ar(cereal::make_nvp("count", count), cereal::make_nvp("sum", sum), cereal::make_nvp("sum_sq", sumSq),
+               cereal::make_nvp("min", min), cereal::make_nvp("max", max));
+        }
+
+        template<class Archive>
+        void load(Archive &ar) {
+            ar(cereal::make_nvp("count", count), cereal::make_nvp("sum", sum), cereal::make_nvp("sum_sq", sumSq),
+               cereal::make_nvp("min", min), cereal::make_nvp("max", max));
+        }
+    };
+
+    /**
+    * @brief histogram of fixed-width bins from zero, the last bin holds the values past the range, mergeable
+    */
+    struct Histogram {
+    public:
+        double binWidth;
+        std::vector<std::size_t> counts;
+
+        explicit Histogram(double binWidth = 1.0, std::size_t bins = 0);
+
+        void Add(double value);
+
+        void Merge(const Histogram &other);
+
+        template<class Archive>
+        void save(Archive &ar) const {
+            ar(cereal::make_nvp("bin_width", binWidth), cereal::make_nvp("counts", counts));
+        }
+
+        template<class Archive>
+        void load(Archive &ar) {
+            ar(cereal::make_nvp("bin_width", binWidth), cereal::make_nvp("counts", counts));
+        }
+    };
+
+    /**
+    * @brief reprojection errors (pixels) of the observations of an intrinsic, mergeable
+    */
+    struct ReprojectionStats {
+    public:
+        std::size_t count = 0;
+        double sumSq = 0.0, max = 0.0;
+
+        void Add(double error);
+
+        void Merge(const ReprojectionStats &other);
+
+        [[nodiscard]] double RMSE() const;
+
+        template<class Archive>
+        void save(Archive &ar) const {
+            ar(cereal::make_nvp("count", count), cereal::make_nvp("sum_sq", sumSq), cereal::make_nvp("max", max));
+        }
+
+        template<class Archive>
+        void load(Archive &ar) {
+            ar(cereal::make_nvp("count", count), cereal::make_nvp("sum_sq", sumSq), cereal::make_nvp("max", max));
+        }
+    };
+
+    struct StatisticsOptions {
+    public:
+        // track lengths (number of observations) past this one share the last bin
+        std::size_t maxTrackLength = 50;
+        // bins (degrees) of the triangulation angle histogram
+        double angleBinWidth = 1.0;
+        std::size_t angleBins = 90;
+        // bins (scene units) of the baseline histogram
+        double baselineBinWidth = 1.0;
+        std::size_t baselineBins = 100;
+        // reproject the observations (of views with a pose and an intrinsic), the points behind the camera are
+        // not counted
+        bool reprojection = true;
+        bool ignoreDisto = false;
+    };
+
+    /**
+    * @brief the statistics of a scene, serializable
+    */
+    struct SceneStatistics {
+    public:
+        std::size_t views = 0, poses = 0, intrinsics = 0, landmarks = 0, observations = 0;
+        // number of observations per landmark
+        Histogram trackLength;
+        RunningStats trackLengthStats;
+        // number of observations of each view (indexed by View::viewId)
+        HashMap<IndexT, std::size_t> observationsPerView;
+        // reprojection errors (indexed by View::intrinsicId)
+        HashMap<IndexT, ReprojectionStats> reprojection;
+        // bounding box of the landmarks, and their number per unit of volume
+        Vec3d bboxMin = Vec3d::Zero(), bboxMax = Vec3d::Zero();
+        double density = 0.0;
+        // maximum angle (degrees) between the rays of a track (from the centers of the views with a pose)
+        Histogram triangulationAngle;
+        RunningStats triangulationAngleStats;
+        // maximum distance between the centers of the views of a track (with at least two rays)
+        Histogram baseline;
+        RunningStats baselineStats;
+
+        friend std::ostream &operator<<(std::ostream &os, const SceneStatistics &stats);
+
+        template<class Archive>
+        void save(Archive &ar) const {
+            ar(cereal::make_nvp("views", views), cereal::make_nvp("poses", poses),
+               cereal::make_nvp("intrinsics", intrinsics), cereal::make_nvp("landmarks", landmarks),
+               cereal::make_nvp("observations", observations));
+            ar(cereal::make_nvp("track_length", trackLength),
+               cereal::make_nvp("track_length_stats", trackLengthStats));
+            ar(cereal::make_nvp("observations_per_view", observationsPerView));
+            ar(cereal::make_nvp("reprojection", reprojection));
+            const std::vector<double> bbox{bboxMin(0), bboxMin(1), bboxMin(2), bboxMax(0), bboxMax(1), bboxMax(2)};
+            ar(cereal::make_nvp("bbox", bbox), cereal::make_nvp("density", density));
+            ar(cereal::make_nvp("triangulation_angle", triangulationAngle),
+               cereal::make_nvp("triangulation_angle_stats", triangulationAngleStats));
+            ar(cereal::make_nvp("baseline", baseline), cereal::make_nvp("baseline_stats", baselineStats));
+        }
+
+        template<class Archive>
+        void load(Archive &ar) {
+            ar(cereal::make_nvp("views", views), cereal::make_nvp("poses", poses),
+               cereal::make_nvp("intrinsics", intrinsics), cereal::make_nvp("landmarks", landmarks),
+               cereal::make_nvp("observations", observations));
+            ar(cereal::make_nvp("track_length", trackLength),
+               cereal::make_nvp("track_length_stats", trackLengthStats));
+            ar(cereal::make_nvp("observations_per_view", observationsPerView));
+            ar(cereal::make_nvp("reprojection", reprojection));
+            std::vector<double> bbox(6);
+            ar(cereal::make_nvp("bbox", bbox), cereal::make_nvp("density", density));
+            bboxMin = Eigen::Map<const Vec3d>(&bbox[0]);
+            bboxMax = Eigen::Map<const Vec3d>(&bbox[3]);
+            ar(cereal::make_nvp("triangulation_angle", triangulationAngle),
+               cereal::make_nvp("triangulation_angle_stats", triangulationAngleStats));
+            ar(cereal::make_nvp("baseline", baseline), cereal::make_nvp("baseline_stats", baselineStats));
+        }
+    };
+
+    /**
+    * @brief Compute the statistics of a scene in a single parallel sweep over the landmarks: each worker fills its
+    * own accumulators (the reprojections are batched by intrinsic, see 'IntrinsicBase::Residuals'), which are
+    * merged at the end
+    */
+    SceneStatistics ComputeStatistics(const Veta &veta, const StatisticsOptions &options = StatisticsOptions());
+}
+
+#endif //VETA_STATISTICS_H
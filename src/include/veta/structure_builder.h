@@ -0,0 +1,107 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_STRUCTURE_BUILDER_H
+#define VETA_STRUCTURE_BUILDER_H
+
+#include "veta/veta.h"
+#include <atomic>
+#include <deque>
+
+namespace ns_veta {
+
+    /**
+    * @brief Concurrent bulk insertion of landmarks and observations. Each producer thread stages its additions in
+    * its own 'Writer' (without any lock), then 'Merge' dispatches them to shards by landmark id and merges the
+    * shards into the structure in parallel.
+    */
+    class StructureBuilder {
+    public:
+        using Ptr = std::shared_ptr<StructureBuilder>;
+
+    protected:
+        struct StagedObservation {
+        public:
+            IndexT lmId, viewId;
+            Observation obs;
+        };
+
+        struct Staging {
+        public:
+            std::vector<std::pair<IndexT, Landmark>> landmarks;
+            std::vector<StagedObservation> observations;
+        };
+
+    public:
+        /**
+        * @brief the staging buffer of a producer thread, a writer must not be used by several threads at once
+        */
+        class Writer {
+        protected:
+            friend class StructureBuilder;
+
+            StructureBuilder *builder;
+            Staging *staging;
+
+            Writer(StructureBuilder *builder, Staging *staging);
+
+        public:
+            /**
+            * @brief stage a landmark, the observations of a landmark staged several times are merged
+            */
+            void AddLandmark(IndexT lmId, Landmark lm);
+
+            /**
+            * @brief stage an observation of a landmark, staged or already in the structure
+            */
+            void AddObservation(IndexT lmId, IndexT viewId, const Observation &obs);
+
+            /**
+            * @brief a new landmark id, unique among all the writers of the builder
+            */
+            IndexT NewLandmarkId();
+        };
+
+    protected:
+        std::atomic<IndexT> nextLandmarkId;
+
+        std::mutex mutex;
+        // stable addresses, one per writer
+        std::deque<Staging> stagings;
+
+    public:
+        /**
+        * @param firstLandmarkId the first id given by 'NewLandmarkId'
+        */
+        explicit StructureBuilder(IndexT firstLandmarkId = 0);
+
+        static Ptr Create(IndexT firstLandmarkId = 0);
+
+        /**
+        * @brief a new writer, for one producer thread, thread-safe
+        */
+        Writer MakeWriter();
+
+        /**
+        * @brief a new landmark id, thread-safe
+        */
+        IndexT NewLandmarkId();
+
+        /**
+        * @brief the number of staged landmarks and observations, not concurrent with the writers
+        */
+        [[nodiscard]] std::pair<std::size_t, std::size_t> StagedCount() const;
+
+        /**
+        * @brief Merge the staged additions into the structure, not concurrent with the writers; the writers can be
+        * used again afterwards. A staged landmark already in the structure overwrites its position and color, and
+        * its observations are merged into the ones of the structure. A staged observation overwrites the one of
+        * the same view. The observations of landmarks neither staged nor in the structure are dropped.
+        * @return the number of landmarks added to the structure
+        */
+        std::size_t Merge(Landmarks &structure);
+    };
+}
+
+#endif //VETA_STRUCTURE_BUILDER_H
@@ -0,0 +1,99 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_SUB_SCENE_H
+#define VETA_SUB_SCENE_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    // Define the observed landmarks (sorted ids) of each view (indexed by View::viewId)
+    using ViewLandmarks = HashMap<IndexT, std::vector<IndexT>>;
+
+    /**
+    * @brief build the view to landmark index of a structure, O(number of observations)
+    */
+    ViewLandmarks BuildViewLandmarks(const Landmarks &structure);
+
+    /**
+    * @brief A lightweight sub-scene: a subset of the views of a parent scene and the landmarks they observe,
+    * referring to the storage of the parent (which must outlive it and stay unchanged) instead of copying it
+    */
+    class SubSceneRef {
+    public:
+        using Ptr = std::shared_ptr<SubSceneRef>;
+
+    protected:
+        const Veta *parent;
+        // the views of the sub-scene existing in the parent
+        std::set<IndexT> viewIds;
+        // the landmarks observed by at least 'minObservations' views of the sub-scene, sorted
+        std::vector<IndexT> landmarkIds;
+
+    public:
+        /**
+        * @param parent the parent scene
+        * @param viewIds the views of the sub-scene, the ones missing in the parent are ignored
+        * @param index the view to landmark index of 'parent.structure' (see 'BuildViewLandmarks'), so that the
+        * landmarks are found in O(number of observations of the sub-scene)
+        * @param minObservations the minimum number of observations (from the sub-scene) of a kept landmark
+        */
+        SubSceneRef(const Veta &parent, const std::set<IndexT> &viewIds, const ViewLandmarks &index,
+                    std::size_t minObservations = 1);
+
+        static Ptr Create(const Veta &parent, const std::set<IndexT> &viewIds, const ViewLandmarks &index,
+                          std::size_t minObservations = 1);
+
+        [[nodiscard]] const Veta &Parent() const;
+
+        [[nodiscard]] const std::set<IndexT> &ViewIds() const;
+
+        [[nodiscard]] const std::vector<IndexT> &LandmarkIds() const;
+
+        /**
+        * @brief the poses of the views (sorted, unique)
+        */
+        [[nodiscard]] std::vector<IndexT> PoseIds() const;
+
+        /**
+        * @brief the intrinsics of the views (sorted, unique)
+        */
+        [[nodiscard]] std::vector<IndexT> IntrinsicIds() const;
+
+        /**
+        * @brief visit the observations of the kept landmarks made by the views of the sub-scene
+        * @param func 'func(lmId, const Landmark &, viewId, const Observation &)'
+        */
+        template<typename Func>
+        void ForEachObservation(Func &&func) const {
+            for (const IndexT lmId: landmarkIds) {
+                const Landmark &lm = parent->structure.at(lmId);
+                for (const auto &[viewId, obs]: lm.obs) {
+                    if (viewIds.count(viewId) != 0) {
+                        func(lmId, lm, viewId, obs);
+                    }
+                }
+            }
+        }
+
+        /**
+        * @brief copy the sub-scene into a new scene: the views, their poses and intrinsics (the view and
+        * intrinsic objects are shared, as when copying a 'Veta'), the kept landmarks and their observations made
+        * by the views of the sub-scene
+        */
+        [[nodiscard]] Veta Materialize() const;
+    };
+
+    /**
+    * @brief Extract the part of a scene related to a subset of views (see 'SubSceneRef'), in O(size of the
+    * result)
+    * @param index the view to landmark index of 'veta.structure' (see 'BuildViewLandmarks'), built once and
+    * reused for all the extractions from the scene
+    */
+    Veta ExtractSubScene(const Veta &veta, const std::set<IndexT> &viewIds, const ViewLandmarks &index,
+                         std::size_t minObservations = 1);
+}
+
+#endif //VETA_SUB_SCENE_H
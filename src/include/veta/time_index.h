@@ -0,0 +1,131 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_TIME_INDEX_H
+#define VETA_TIME_INDEX_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @brief Views sorted by 'View::timestamp' (views with an undefined timestamp are not indexed)
+    */
+    class ViewTimeIndex {
+    public:
+        using Ptr = std::shared_ptr<ViewTimeIndex>;
+
+    protected:
+        // sorted timestamps and the corresponding view ids
+        std::vector<TimeT> times;
+        std::vector<IndexT> viewIds;
+
+    public:
+        ViewTimeIndex() = default;
+
+        explicit ViewTimeIndex(const Views &views);
+
+        static Ptr Create(const Views &views);
+
+        /**
+        * @brief (re)build the index, O(n log n)
+        */
+        void Build(const Views &views);
+
+        [[nodiscard]] std::size_t Size() const;
+
+        [[nodiscard]] const std::vector<TimeT> &Times() const;
+
+        [[nodiscard]] const std::vector<IndexT> &ViewIds() const;
+
+        /**
+        * @brief the views whose timestamp lies in [t0, t1], sorted by time, O(log n + k)
+        */
+        [[nodiscard]] std::vector<IndexT> InRange(TimeT t0, TimeT t1) const;
+
+        /**
+        * @brief the view whose timestamp is the nearest to 't', O(log n)
+        * @return the view id, 'UndefinedIndexT' if the index is empty
+        */
+        [[nodiscard]] IndexT Nearest(TimeT t) const;
+    };
+
+    /**
+    * @brief Interpolate poses over time from time-stamped key poses
+    */
+    class PoseInterpolator {
+    public:
+        using Ptr = std::shared_ptr<PoseInterpolator>;
+
+        enum Mode : int {
+            /**
+             * @brief SLERP of the rotation and linear interpolation of the translation
+             */
+            SLERP = 0,
+            /**
+             * @brief geodesic on SE3: T(a) = T0 * exp(a * log(T0^-1 * T1))
+             */
+            SE3_GEODESIC = 1,
+            /**
+             * @brief cubic interpolation passing through the key poses: a Catmull-Rom (cubic Hermite with finite
+             * difference tangents) translation, C1 continuous, and a SQUAD rotation
+             */
+            CUBIC_SPLINE = 2
+        };
+
+    protected:
+        // sorted timestamps and key poses
+        std::vector<TimeT> times;
+        std::vector<Posed> poses;
+        // SQUAD control rotations (CUBIC_SPLINE only)
+        std::vector<Quaterniond> quats, squadCtrl;
+        Mode mode;
+
+    public:
+        /**
+        * @param keyPoses time-stamped key poses, sorted or not, duplicated timestamps keep the first pose
+        */
+        explicit PoseInterpolator(std::vector<std::pair<TimeT, Posed>> keyPoses, Mode mode = SE3_GEODESIC);
+
+        /**
+        * @brief use the time-stamped views having a pose as key poses
+        */
+        explicit PoseInterpolator(const Veta &veta, Mode mode = SE3_GEODESIC);
+
+        static Ptr Create(const Veta &veta, Mode mode = SE3_GEODESIC);
+
+        [[nodiscard]] Mode GetMode() const;
+
+        [[nodiscard]] std::size_t Size() const;
+
+        /**
+        * @brief the time range [first, last] covered by the key poses
+        */
+        [[nodiscard]] std::pair<TimeT, TimeT> TimeRange() const;
+
+        /**
+        * @brief interpolate the pose at time 't', O(log n)
+        * @retval false if 't' lies outside of the time range
+        */
+        bool PoseAt(TimeT t, Posed &pose) const;
+
+        /**
+        * @brief interpolate the poses at sorted times, O(n + m)
+        * @param sortedTimes increasing timestamps
+        * @param result the interpolated poses (identity where invalid)
+        * @return a 0/1 flag per timestamp, zero if the timestamp lies outside of the time range
+        */
+        std::vector<uint8_t> PosesAt(const std::vector<TimeT> &sortedTimes, std::vector<Posed> &result) const;
+
+    protected:
+        void Prepare();
+
+        /**
+        * @brief interpolate within the segment [times[i], times[i + 1]]
+        */
+        [[nodiscard]] Posed Interpolate(std::size_t i, TimeT t) const;
+    };
+}
+
+#endif //VETA_TIME_INDEX_H
@@ -0,0 +1,71 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_TRIANGULATION_H
+#define VETA_TRIANGULATION_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @enum TriangulationMethod initial solution of a track
+    * @var DLT
+    *   direct linear transform on the bearings ('[b]x [R|t] X = 0'), in normalized coordinates
+    * @var MIDPOINT
+    *   point closest to all the rays (least squares distance to the rays)
+    */
+    enum class TriangulationMethod : int {
+        DLT = 0,
+        MIDPOINT = 1
+    };
+
+    struct TriangulationOptions {
+    public:
+        TriangulationMethod method = TriangulationMethod::DLT;
+        // Gauss-Newton steps on the bearing errors after the initial solution, zero to disable
+        int refineIterations = 3;
+        // tracks with fewer observations (of views with a pose and an intrinsic) are not triangulated
+        std::size_t minObservations = 2;
+        // minimum angle (degrees) between two rays of a track
+        double minAngle = 1.0;
+        // maximum reprojection error (pixels) of an observation
+        double maxReprojError = std::numeric_limits<double>::max();
+        // only the valid tracks are written back ('Landmark::X')
+        bool writeBack = true;
+        // number of landmarks processed at once, bounds the temporary memory
+        std::size_t batchSize = 1 << 16;
+    };
+
+    /**
+    * @brief quality of a triangulated track
+    */
+    struct TriangulationQuality {
+    public:
+        // observations used (of views with a pose and an intrinsic)
+        std::size_t observations = 0;
+        // maximum angle (degrees) between two rays of the track
+        double maxAngle = 0.0;
+        // reprojection errors (pixels)
+        double meanReprojError = std::numeric_limits<double>::max();
+        double maxReprojError = std::numeric_limits<double>::max();
+        // solved, in front of all the views, and within the angle and error thresholds
+        bool valid = false;
+    };
+
+    // Define the quality of the triangulated tracks (indexed by their landmark id)
+    using TriangulationReport = HashMap<IndexT, TriangulationQuality>;
+
+    /**
+    * @brief (Re)triangulate every track of the scene from its observations. The observations are unprojected in
+    * batches by the intrinsic of their view ('IntrinsicBase::operator()'), each track is solved in parallel with
+    * fixed-size solvers ('TriangulationMethod') then refined by a few Gauss-Newton steps, and the reprojection
+    * errors are computed in batches by 'IntrinsicBase::Residuals'. The poses are world to camera (as for
+    * 'GetProjectiveEquivalent').
+    * @return the quality of each track
+    */
+    TriangulationReport Triangulate(Veta &veta, const TriangulationOptions &options = TriangulationOptions());
+}
+
+#endif //VETA_TRIANGULATION_H
@@ -16,6 +16,7 @@
 #include "map"
 
 #include "veta/utils.hpp"
+#include "veta/arena.h"
 
 // Extend EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION with initializer list support.
 #define EIGEN_DEFINE_STL_VECTOR_SPECIALIZATION_INITIALIZER_LIST(...)             \
@@ -70,9 +71,19 @@ namespace ns_veta {
     // Vector of Pair
     using PairVec = std::vector<Pair>;
 
+    /**
+    * @brief ordered map of the scene containers
+    * @note defining 'VETA_ARENA_CONTAINERS' (cmake option of the same name) allocates the nodes from a shared
+    * memory resource (see 'ResourceAllocator' in 'arena.h'), so that a scene can live in an 'ArenaResource'
+    */
+#ifdef VETA_ARENA_CONTAINERS
+    template<typename Key, typename Value>
+    using HashMap = std::map<Key, Value, std::less<Key>, ResourceAllocator<std::pair<const Key, Value>>>;
+#else
     template<typename Key, typename Value>
     using HashMap = std::map<Key, Value, std::less<Key>,
             Eigen::aligned_allocator<std::pair<const Key, Value>>>;
+#endif
 
     using Eigen::Map;
 
@@ -6,6 +6,9 @@
 #define VETA_UTILS_HPP
 
 #include <functional>
+#include <thread>
+#include <exception>
+#include <mutex>
 
 #include "cereal/cereal.hpp"
 #include "cereal/archives/json.hpp"
@@ -20,8 +23,22 @@
 #include "sophus/se3.hpp"
 
 namespace ns_veta {
+    /**
+    * @brief whether a matrix is a rotation: R^T * R = I (up to 'eps' per coefficient) and det(R) > 0
+    */
+    template<class ScalarType>
+    inline bool IsRotationMatrix(const Sophus::Matrix3<ScalarType> &rotMat,
+                                 ScalarType eps = 8 * Eigen::NumTraits<ScalarType>::epsilon()) {
+        const Sophus::Matrix3<ScalarType> err = rotMat.transpose() * rotMat - Sophus::Matrix3<ScalarType>::Identity();
+        return err.cwiseAbs().maxCoeff() <= eps && rotMat.determinant() > ScalarType(0);
+    }
+
     template<class ScalarType>
     inline Sophus::Matrix3<ScalarType> AdjustRotationMatrix(const Sophus::Matrix3<ScalarType> &rotMat) {
+        // already orthonormal, no SVD
+        if (IsRotationMatrix(rotMat)) {
+            return rotMat;
+        }
         // adjust
         Eigen::JacobiSVD<Sophus::Matrix3<ScalarType>> svd(rotMat, Eigen::ComputeFullV | Eigen::ComputeFullU);
         const Sophus::Matrix3<ScalarType> &vMatrix = svd.matrixV();
@@ -115,6 +132,71 @@ namespace ns_veta {
         return fname;
     }
 
+    /**
+    * @brief number of worker threads used by the parallel passes (at least one)
+    */
+    inline unsigned int HardwareThreads() {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+    * @brief split [begin, end) into contiguous chunks and run 'func(chunkBegin, chunkEnd, workerIdx)' on each
+    * chunk in its own thread, the first exception thrown by a worker is rethrown to the caller
+    * @param minChunk the minimum number of items per chunk, small ranges run on the calling thread
+    * @param maxWorkers the maximum number of workers (chunks), zero for 'HardwareThreads()'
+    * @return the number of workers used, 'workerIdx' lies in [0, workers)
+    */
+    template<typename Func>
+    std::size_t ParallelForRange(std::size_t begin, std::size_t end, Func &&func,
+                                 std::size_t minChunk = 1024, std::size_t maxWorkers = 0) {
+        if (end <= begin) {
+            return 0;
+        }
+        const std::size_t count = end - begin;
+        const std::size_t limit = maxWorkers ? maxWorkers : HardwareThreads();
+        const std::size_t workers = std::max<std::size_t>(1, std::min(limit, count / std::max<std::size_t>(minChunk, 1)));
+        if (workers == 1) {
+            func(begin, end, std::size_t(0));
+            return 1;
+        }
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto run = [&](std::size_t w) {
+            const std::size_t lo = begin + count * w / workers, hi = begin + count * (w + 1) / workers;
+            try {
+                func(lo, hi, w);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) { error = std::current_exception(); }
+            }
+        };
+        for (std::size_t w = 1; w < workers; ++w) {
+            threads.emplace_back(run, w);
+        }
+        run(0);
+        for (auto &t: threads) {
+            t.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return workers;
+    }
+
+    /**
+    * @brief run 'func(i)' for each i in [begin, end) in parallel (see 'ParallelForRange')
+    */
+    template<typename Func>
+    void ParallelFor(std::size_t begin, std::size_t end, Func &&func, std::size_t minChunk = 1024) {
+        ParallelForRange(begin, end, [&func](std::size_t lo, std::size_t hi, std::size_t) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                func(i);
+            }
+        }, minChunk);
+    }
+
     /// Allow to select the Keys of a map.
     struct RetrieveKey {
         template<typename T>
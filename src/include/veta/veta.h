@@ -25,6 +25,45 @@ namespace ns_veta {
     // Define a collection of landmarks are indexed by their TrackId
     using Landmarks = HashMap<IndexT, Landmark>;
 
+    /**
+    * @brief the new ids of the elements of a scene after a renumbering (indexed by their previous id)
+    */
+    struct IdMap {
+    public:
+        HashMap<IndexT, IndexT> views, poses, intrinsics, landmarks;
+    };
+
+    /**
+    * @brief serialize a collection of landmarks using an explicit observation encoding (see 'ObsEncoding')
+    */
+    template<class LandmarksType>
+    struct EncodedLandmarks {
+    public:
+        LandmarksType &lms;
+        ObsEncoding encoding;
+
+        template<class Archive>
+        void save(Archive &ar) const {
+            ar(cereal::make_size_tag(static_cast<cereal::size_type>(lms.size())));
+            for (const auto &[lmId, lm]: lms) {
+                ar(cereal::make_map_item(lmId, EncodedLandmark<const Landmark>{lm, encoding}));
+            }
+        }
+
+        template<class Archive>
+        void load(Archive &ar) {
+            cereal::size_type size;
+            ar(cereal::make_size_tag(size));
+            lms.clear();
+            for (cereal::size_type i = 0; i < size; ++i) {
+                IndexT lmId;
+                Landmark lm;
+                ar(cereal::make_map_item(lmId, EncodedLandmark<Landmark>{lm, encoding}));
+                lms.emplace_hint(lms.end(), lmId, std::move(lm));
+            }
+        }
+    };
+
     struct IndexGenerator {
     protected:
         static IndexT ViewIdCounter;
@@ -120,6 +159,10 @@ namespace ns_veta {
             return os;
         };
 
+    protected:
+        // the memory resource of the loaded elements, declared first to outlive the containers
+        std::shared_ptr<std::pmr::memory_resource> resource;
+
     public:
 
         /// Considered views
@@ -136,9 +179,79 @@ namespace ns_veta {
 
         Veta();
 
+        /**
+        * @brief a scene allocating from a memory resource (e.g. an 'ArenaResource'), which it keeps alive
+        * @note the containers (views, poses, intrinsics, structure and the observations of the landmarks) are
+        * allocated from the resource when 'VETA_ARENA_CONTAINERS' is defined, the shared views and intrinsics are
+        * always allocated on the heap
+        */
+        explicit Veta(std::shared_ptr<std::pmr::memory_resource> resource);
+
+        /**
+        * @brief a copy on the memory resource of 'other', which it keeps alive: the containers and their nested
+        * containers (e.g. the observations) are allocated from it
+        */
+        Veta(const Veta &other);
+
+        Veta(Veta &&other) = default;
+
+        /**
+        * @brief the containers keep their allocators, so the scene keeps its memory resource, the nested containers
+        * are copied into it as well
+        */
+        Veta &operator=(const Veta &other);
+
+        /**
+        * @brief the allocators are moved with the elements, so the scene takes the memory resource of 'other', the
+        * previous one is kept alive until the previous elements are destroyed
+        */
+        Veta &operator=(Veta &&other);
+
         static Ptr Create();
+
+        static Ptr Create(std::shared_ptr<std::pmr::memory_resource> resource);
+
+        /**
+        * @return the memory resource of the scene, nullptr for the heap
+        */
+        [[nodiscard]] const std::shared_ptr<std::pmr::memory_resource> &Resource() const;
     };
 
+    /**
+    * @brief read the header of a cereal scene file: the version and, for versions other than '0.1', the encoding
+    * of the observations in the 'structure' part
+    * @return the encoding, files of version '0.1' always store the observations using the legacy (double) encoding
+    * @throw cereal::Exception for an unknown encoding
+    */
+    template<class Archive>
+    ObsEncoding LoadVetaHeader(Archive &archive) {
+        std::string version;
+        archive(cereal::make_nvp("veta_version", version));
+        int encoding = static_cast<int>(ObsEncoding::DOUBLE);
+        if (version != "0.1") {
+            archive(cereal::make_nvp("structure_encoding", encoding));
+            if (encoding != static_cast<int>(ObsEncoding::DOUBLE) &&
+                encoding != static_cast<int>(ObsEncoding::FLOAT32) &&
+                encoding != static_cast<int>(ObsEncoding::FIXED_POINT)) {
+                throw cereal::Exception("unknown structure encoding " + std::to_string(encoding));
+            }
+        }
+        return static_cast<ObsEncoding>(encoding);
+    }
+
+    /**
+    * @brief write the header of a cereal scene file: the legacy encoding keeps the '0.1' layout, others record the
+    * encoding after the version '0.2'
+    */
+    template<class Archive>
+    void SaveVetaHeader(Archive &archive, ObsEncoding encoding) {
+        const std::string version = encoding == ObsEncoding::DOUBLE ? "0.1" : "0.2";
+        archive(cereal::make_nvp("veta_version", version));
+        if (encoding != ObsEncoding::DOUBLE) {
+            archive(cereal::make_nvp("structure_encoding", static_cast<int>(encoding)));
+        }
+    }
+
     template<typename archiveType>
     bool LoadCereal(Veta &data, const std::string &filename, Veta::Parts flag) {
         const bool bBinary = ExtensionPart(filename) == "bin";
@@ -150,10 +263,11 @@ namespace ns_veta {
 
         // Data serialization
         try {
+            // the nested containers (e.g. the observations) are allocated from the resource of the scene
+            const ScopedResource scope(data.Resource());
             archiveType archive(stream);
 
-            std::string version;
-            archive(cereal::make_nvp("veta_version", version));
+            const ObsEncoding encoding = LoadVetaHeader(archive);
 
             if (Veta::IsPartsWith(Veta::VIEWS, flag)) {
                 archive(cereal::make_nvp("views", data.views));
@@ -182,12 +296,12 @@ namespace ns_veta {
             }
 
             if (Veta::IsPartsWith(Veta::STRUCTURE, flag))
-                archive(cereal::make_nvp("structure", data.structure));
+                archive(cereal::make_nvp("structure", EncodedLandmarks<Landmarks>{data.structure, encoding}));
             else if (bBinary) {
                 // Binary file requires to read all the member,
                 // read in a temporary object since the data is not needed.
                 Landmarks structure;
-                archive(cereal::make_nvp("structure", structure));
+                archive(cereal::make_nvp("structure", EncodedLandmarks<Landmarks>{structure, encoding}));
             }
         }
         catch (const cereal::Exception &e) {
@@ -200,7 +314,8 @@ namespace ns_veta {
     }
 
     template<typename archiveType>
-    bool SaveCereal(const Veta &data, const std::string &filename, Veta::Parts flag) {
+    bool SaveCereal(const Veta &data, const std::string &filename, Veta::Parts flag,
+                    ObsEncoding encoding = ObsEncoding::DOUBLE) {
 
         //Create the stream and check it is ok
         std::ofstream stream(filename.c_str(), std::ios::binary | std::ios::out);
@@ -211,8 +326,7 @@ namespace ns_veta {
         // Data serialization
         {
             archiveType archive(stream);
-            const std::string version = "0.1";
-            archive(cereal::make_nvp("veta_version", version));
+            SaveVetaHeader(archive, encoding);
 
             if (Veta::IsPartsWith(Veta::VIEWS, flag))
                 archive(cereal::make_nvp("views", data.views));
@@ -231,7 +345,7 @@ namespace ns_veta {
 
             // Structure -> See for export in another file
             if (Veta::IsPartsWith(Veta::STRUCTURE, flag))
-                archive(cereal::make_nvp("structure", data.structure));
+                archive(cereal::make_nvp("structure", EncodedLandmarks<const Landmarks>{data.structure, encoding}));
             else
                 archive(cereal::make_nvp("structure", Landmarks()));
         }
@@ -252,16 +366,20 @@ namespace ns_veta {
     LoadCereal<cereal::XMLInputArchive>(Veta &data, const std::string &filename, Veta::Parts flag);
 
     template bool
-    SaveCereal<cereal::BinaryOutputArchive>(const Veta &data, const std::string &filename, Veta::Parts flag);
+    SaveCereal<cereal::BinaryOutputArchive>(const Veta &data, const std::string &filename, Veta::Parts flag,
+                                            ObsEncoding encoding);
 
     template bool
-    SaveCereal<cereal::PortableBinaryOutputArchive>(const Veta &data, const std::string &filename, Veta::Parts flag);
+    SaveCereal<cereal::PortableBinaryOutputArchive>(const Veta &data, const std::string &filename, Veta::Parts flag,
+                                                    ObsEncoding encoding);
 
     template bool
-    SaveCereal<cereal::JSONOutputArchive>(const Veta &data, const std::string &filename, Veta::Parts flag);
+    SaveCereal<cereal::JSONOutputArchive>(const Veta &data, const std::string &filename, Veta::Parts flag,
+                                          ObsEncoding encoding);
 
     template bool
-    SaveCereal<cereal::XMLOutputArchive>(const Veta &data, const std::string &filename, Veta::Parts flag);
+    SaveCereal<cereal::XMLOutputArchive>(const Veta &data, const std::string &filename, Veta::Parts flag,
+                                         ObsEncoding encoding);
 
     ///Check that each pose have a valid intrinsic and pose id in the existing View ids
     bool ValidIds(const Veta &veta, Veta::Parts flag);
@@ -269,8 +387,13 @@ namespace ns_veta {
     /// Load SfM_Data SfM scene from a file
     bool Load(Veta &veta, const std::string &filename, Veta::Parts flag);
 
-    // Save SfM_Data SfM scene to a file
-    bool Save(const Veta &veta, const std::string &filename, Veta::Parts flag);
+    /**
+    * @brief Save SfM_Data SfM scene to a file
+    * @param encoding encoding of the observations in the 'structure' part, 'ObsEncoding::DOUBLE' is lossless
+    * and keeps the legacy file layout, others shrink the file at the precision documented in 'ObsEncoding'
+    */
+    bool Save(const Veta &veta, const std::string &filename, Veta::Parts flag,
+              ObsEncoding encoding = ObsEncoding::DOUBLE);
 
 
 }
@@ -0,0 +1,217 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_VIEW_POOL_H
+#define VETA_VIEW_POOL_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @brief Views stored by value in a contiguous pool, addressed by stable handles (slot indexes, valid until the
+    * view is erased), instead of one allocation and one reference count per view as in 'Views'. The pool is
+    * serialized exactly as 'Views', so that it loads and saves the 'views' part of the existing files (see
+    * 'LoadViews' and 'SaveViews').
+    * @note the pool is a standalone container for the view-only workloads (e.g. time or id lookups over large
+    * sequences), 'Veta::views' stays a map of shared views: the algorithms on a scene and 'Load'/'Save' use it, and
+    * 'View' keeps its virtual destructor for the derived views serialized through the polymorphic pointers. Use
+    * 'ToViews' to hand the views over to a scene.
+    * @note views are indexed by 'View::viewId' in a sorted array: inserting by increasing ids is amortized constant,
+    * other insertions and erasures are linear
+    */
+    class ViewPool {
+    public:
+        using Ptr = std::shared_ptr<ViewPool>;
+
+        using Handle = uint32_t;
+
+        static constexpr Handle InvalidHandle = std::numeric_limits<Handle>::max();
+
+    protected:
+        // the slots, freed ones are reused
+        std::vector<View> slots;
+        std::vector<Handle> freeSlots;
+        // (view id, handle) sorted by view id
+        std::vector<std::pair<IndexT, Handle>> index;
+
+    public:
+        ViewPool() = default;
+
+        explicit ViewPool(const Views &views);
+
+        static Ptr Create(const Views &views = Views());
+
+        void Reserve(std::size_t size);
+
+        void Clear();
+
+        [[nodiscard]] std::size_t Size() const;
+
+        [[nodiscard]] bool Empty() const;
+
+        /**
+        * @brief insert a view under 'View::viewId', or overwrite the view of the same id
+        * @return the handle of the view
+        */
+        Handle Insert(const View &view);
+
+        /**
+        * @retval false if there is no view of this id
+        */
+        bool Erase(IndexT viewId);
+
+        /**
+        * @return the handle of the view, 'InvalidHandle' if missing, O(log n)
+        */
+        [[nodiscard]] Handle Find(IndexT viewId) const;
+
+        /**
+        * @return the view, nullptr if missing
+        */
+        [[nodiscard]] const View *Get(IndexT viewId) const;
+
+        View *Get(IndexT viewId);
+
+        [[nodiscard]] const View &operator[](Handle handle) const;
+
+        View &operator[](Handle handle);
+
+        /**
+        * @brief the (view id, handle) pairs, sorted by view id
+        */
+        [[nodiscard]] const std::vector<std::pair<IndexT, Handle>> &Index() const;
+
+        /**
+        * @brief visit the views by increasing id: 'func(viewId, view)'
+        */
+        template<typename Func>
+        void ForEach(Func &&func) const {
+            for (const auto &[viewId, handle]: index) {
+                func(viewId, slots[handle]);
+            }
+        }
+
+        template<typename Func>
+        void ForEach(Func &&func) {
+            for (const auto &[viewId, handle]: index) {
+                func(viewId, slots[handle]);
+            }
+        }
+
+        /**
+        * @brief copy the views into the shared storage of 'Veta'
+        */
+        [[nodiscard]] Views ToViews() const;
+
+    public:
+        /**
+        * @brief Serialization out, as 'Views' (a map of polymorphic shared pointers)
+        * @param ar Archive
+        */
+        template<class Archive>
+        void save(Archive &ar) const {
+            ar(cereal::make_size_tag(static_cast<cereal::size_type>(index.size())));
+            for (const auto &[viewId, handle]: index) {
+                // a non-owning pointer to the slot, serialized by the shared pointer machinery of cereal
+                const std::shared_ptr<const View> view(std::shared_ptr<const View>(), &slots[handle]);
+                ar(cereal::make_map_item(viewId, view));
+            }
+        }
+
+        /**
+        * @brief Serialization in, from 'Views', without any allocation per view
+        * @param ar Archive
+        */
+        template<class Archive>
+        void load(Archive &ar) {
+            cereal::size_type size;
+            ar(cereal::make_size_tag(size));
+            Clear();
+            Reserve(size);
+            // the handles of the loaded pointer ids, for the pointers shared by several keys
+            std::map<uint32_t, Handle> handles;
+            for (cereal::size_type i = 0; i < size; ++i) {
+                IndexT viewId;
+                SharedViewLoader loader;
+                ar(cereal::make_map_item(viewId, loader));
+                if (loader.id == 0) {
+                    // null view, skipped as by the algorithms on 'Views'
+                    continue;
+                }
+                if (loader.id & cereal::detail::msb_32bit) {
+                    loader.view.viewId = viewId;
+                    handles[loader.id & ~cereal::detail::msb_32bit] = Insert(loader.view);
+                } else {
+                    auto iter = handles.find(loader.id);
+                    if (iter == handles.cend()) {
+                        throw cereal::Exception("unknown shared view pointer id " + std::to_string(loader.id));
+                    }
+                    View view = slots[iter->second];
+                    view.viewId = viewId;
+                    Insert(view);
+                }
+            }
+        }
+
+    protected:
+        /**
+        * @brief reads a polymorphic 'std::shared_ptr<View>' as written by cereal: the 'polymorphic_id', then the
+        * 'ptr_wrapper' holding the pointer 'id' and, for its first occurrence, the 'data'
+        * @note this mirrors the layout of 'cereal/types/polymorphic.hpp' and 'cereal/types/memory.hpp', the round
+        * trip with the files written by 'Save' is checked by the 'view_pool' test
+        */
+        struct SharedViewLoader {
+        public:
+            // zero for a null pointer, with the msb set for the first occurrence of a pointer
+            uint32_t id = 0;
+            View view;
+
+            template<class Archive>
+            void load(Archive &ar) {
+                uint32_t polymorphicId;
+                ar(cereal::make_nvp("polymorphic_id", polymorphicId));
+                if (polymorphicId == 0) {
+                    return;
+                }
+                if (!(polymorphicId & cereal::detail::msb2_32bit)) {
+                    throw cereal::Exception("a view of a derived type can not be stored by value");
+                }
+                PtrWrapperLoader wrapper{*this};
+                ar(cereal::make_nvp("ptr_wrapper", wrapper));
+            }
+        };
+
+        struct PtrWrapperLoader {
+        public:
+            SharedViewLoader &loader;
+
+            template<class Archive>
+            void load(Archive &ar) {
+                ar(cereal::make_nvp("id", loader.id));
+                if (loader.id & cereal::detail::msb_32bit) {
+                    ar(cereal::make_nvp("data", loader.view));
+                }
+            }
+        };
+    };
+
+    /**
+    * @brief Load the 'views' part of a scene file ('.json', '.bin', '.xml' or '.vetac', see 'Load') into a pool,
+    * without one allocation per view, the other parts are not read
+    * @param encoding if not null, receives the observation encoding of the file (see 'SaveViews')
+    */
+    bool LoadViews(ViewPool &pool, const std::string &filename, ObsEncoding *encoding = nullptr);
+
+    /**
+    * @brief Save a pool to a views-only file ('.json', '.bin', '.xml' or '.vetac'), which loads as a scene saved
+    * with 'Veta::VIEWS': the other parts are saved empty
+    * @param encoding the header of the file (see 'Save'), e.g. the one of the file the views were loaded from
+    * @attention an existing file is overwritten (as by 'Save') and the output only contains the views: saving to
+    * the scene file the views were loaded from drops its intrinsics, extrinsics and structure
+    */
+    bool SaveViews(const ViewPool &pool, const std::string &filename, ObsEncoding encoding = ObsEncoding::DOUBLE);
+}
+
+#endif //VETA_VIEW_POOL_H
@@ -0,0 +1,59 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_VISIBILITY_H
+#define VETA_VISIBILITY_H
+
+#include "veta/veta.h"
+#include "veta/spatial_index.h"
+
+namespace ns_veta {
+
+    // Define the visible landmarks (sorted ids) of each view (indexed by View::viewId)
+    using Visibility = HashMap<IndexT, std::vector<IndexT>>;
+
+    struct VisibilityOptions {
+    public:
+        // landmarks closer than this depth (along the optical axis) are not visible
+        double minDepth = 1E-6;
+        // landmarks farther than this depth (along the optical axis) are not visible
+        double maxDepth = std::numeric_limits<double>::max();
+        // margin (in pixels) removed from each image border
+        double border = 0.0;
+        // project without the distortion field
+        bool ignoreDisto = false;
+        // number of landmarks projected at once
+        std::size_t batchSize = 4096;
+    };
+
+    /**
+    * @brief Compute the landmarks projecting inside the image of each view and lying in front of the camera.
+    * Views are processed in parallel, for each one the candidate landmarks are transformed by the view pose
+    * (world to camera, as for 'GetProjectiveEquivalent'), checked for cheirality, projected by the view intrinsic
+    * ('IntrinsicBase::ProjectPoints') and tested against the image bounds ('View::imgWidth x View::imgHeight',
+    * or the intrinsic size if undefined).
+    * @param veta the scene
+    * @param viewIds the views to process, all views with a pose and an intrinsic if empty
+    * @param index an optional spatial index over 'veta.structure', used to cull the landmarks outside the
+    * frustum of pinhole views; if null, every landmark is a candidate
+    * @return the visible landmarks of each processed view
+    */
+    Visibility ComputeVisibility(const Veta &veta, const std::vector<IndexT> &viewIds = {},
+                                 const LandmarkKdTree *index = nullptr,
+                                 const VisibilityOptions &options = VisibilityOptions());
+
+    /**
+    * @brief Compute the landmarks (one per column of 'X') projecting inside an image
+    * @param worldToCam the pose of the view
+    * @param intrinsic the intrinsic of the view
+    * @param width width of the image
+    * @param height height of the image
+    * @return a 0/1 flag per landmark
+    */
+    std::vector<uint8_t> VisibleMask(const Mat3Xd &X, const Posed &worldToCam, const IntrinsicBase &intrinsic,
+                                     double width, double height,
+                                     const VisibilityOptions &options = VisibilityOptions());
+}
+
+#endif //VETA_VISIBILITY_H
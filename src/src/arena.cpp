@@ -0,0 +1,129 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/arena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace ns_veta {
+
+    namespace {
+        std::shared_ptr<std::pmr::memory_resource> &CurrentResourceSlot() {
+            thread_local std::shared_ptr<std::pmr::memory_resource> resource;
+            return resource;
+        }
+    }
+
+    std::ostream &operator<<(std::ostream &os, const ArenaStats &stats) {
+        os << "chunks: " << stats.chunks << " (large: " << stats.largeChunks << "), reserved: "
+           << stats.reservedBytes << " B, used: " << stats.usedBytes << " B, wasted: " << stats.wastedBytes
+           << " B, allocations: " << stats.allocations << ", deallocations: " << stats.deallocations
+           << ", largest allocation: " << stats.largestAllocation << " B";
+        return os;
+    }
+
+    // -------------
+    // ArenaResource
+    // -------------
+
+    ArenaResource::ArenaResource(std::size_t chunkSize, std::pmr::memory_resource *upstream, bool synchronized)
+            : upstream(upstream), chunkSize(std::max<std::size_t>(chunkSize, 1024)), synchronized(synchronized) {}
+
+    ArenaResource::Ptr ArenaResource::Create(std::size_t chunkSize, std::pmr::memory_resource *upstream,
+                                             bool synchronized) {
+        return std::make_shared<ArenaResource>(chunkSize, upstream, synchronized);
+    }
+
+    ArenaResource::~ArenaResource() {
+        Release();
+    }
+
+    void ArenaResource::Release() {
+        const auto lock = Lock();
+        for (const Chunk &chunk: chunks) {
+            upstream->deallocate(chunk.data, chunk.size, alignof(std::max_align_t));
+        }
+        chunks.clear();
+        cur = end = nullptr;
+        stats = ArenaStats();
+    }
+
+    std::size_t ArenaResource::ChunkSize() const {
+        return chunkSize;
+    }
+
+    ArenaStats ArenaResource::Stats() const {
+        const auto lock = Lock();
+        return stats;
+    }
+
+    bool ArenaResource::Synchronized() const {
+        return synchronized;
+    }
+
+    std::unique_lock<std::mutex> ArenaResource::Lock() const {
+        return synchronized ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>();
+    }
+
+    void *ArenaResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+        const auto lock = Lock();
+        ++stats.allocations;
+        stats.largestAllocation = std::max(stats.largestAllocation, bytes);
+
+        // allocations larger than a quarter of a chunk get their own chunk, the current one is kept
+        if (bytes + alignment > chunkSize / 4) {
+            const std::size_t size = bytes + alignment;
+            void *data = upstream->allocate(size, alignof(std::max_align_t));
+            chunks.push_back({data, size});
+            ++stats.chunks;
+            ++stats.largeChunks;
+            stats.reservedBytes += size;
+            stats.usedBytes += size;
+            const auto addr = reinterpret_cast<std::uintptr_t>(data);
+            return reinterpret_cast<void *>((addr + alignment - 1) & ~(alignment - 1));
+        }
+
+        auto addr = reinterpret_cast<std::uintptr_t>(cur);
+        std::uintptr_t aligned = (addr + alignment - 1) & ~(alignment - 1);
+        if (cur == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end)) {
+            stats.wastedBytes += end - cur;
+            cur = static_cast<char *>(upstream->allocate(chunkSize, alignof(std::max_align_t)));
+            end = cur + chunkSize;
+            chunks.push_back({cur, chunkSize});
+            ++stats.chunks;
+            stats.reservedBytes += chunkSize;
+            addr = reinterpret_cast<std::uintptr_t>(cur);
+            aligned = (addr + alignment - 1) & ~(alignment - 1);
+        }
+        cur = reinterpret_cast<char *>(aligned + bytes);
+        stats.usedBytes += aligned + bytes - addr;
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    void ArenaResource::do_deallocate(void *, std::size_t, std::size_t) {
+        const auto lock = Lock();
+        ++stats.deallocations;
+    }
+
+    bool ArenaResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+        return this == &other;
+    }
+
+    // --------------
+    // ScopedResource
+    // --------------
+
+    const std::shared_ptr<std::pmr::memory_resource> &CurrentResource() {
+        return CurrentResourceSlot();
+    }
+
+    ScopedResource::ScopedResource(std::shared_ptr<std::pmr::memory_resource> resource)
+            : previous(std::move(CurrentResourceSlot())) {
+        CurrentResourceSlot() = std::move(resource);
+    }
+
+    ScopedResource::~ScopedResource() {
+        CurrentResourceSlot() = std::move(previous);
+    }
+}
@@ -3,6 +3,7 @@
 //
 
 #include "veta/camera/intrinsics.h"
+#include "veta/simd.h"
 
 namespace ns_veta {
 
@@ -24,11 +25,60 @@ namespace ns_veta {
         }
     }
 
+    Mat2Xd IntrinsicBase::ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const {
+        Mat2Xd x(2, X.cols());
+        for (Mat3Xd::Index i = 0; i < X.cols(); ++i) {
+            x.col(i) = this->Project(X.col(i), ignoreDisto);
+        }
+        return x;
+    }
+
     Vec2d IntrinsicBase::Residual(const Vec3d &X, const Vec2d &x, bool ignoreDisto) const {
         const Vec2d proj = this->Project(X, ignoreDisto);
         return x - proj;
     }
 
+    std::vector<double> IntrinsicBase::GetParams() const {
+        const double *params = this->ParamsAddress();
+        return {params, params + this->ParamsSize()};
+    }
+
+    bool IntrinsicBase::UpdateFromParams(const std::vector<double> &params) {
+        return UpdateFromParams(params.data(), params.size());
+    }
+
+    bool IntrinsicBase::UpdateFromParams(const double *params, std::size_t size) {
+        if (size != this->ParamsSize()) {
+            return false;
+        }
+        double *block = this->ParamsAddress();
+        if (size != 0 && block != params) {
+            std::copy_n(params, size, block);
+        }
+        this->UpdateDerived();
+        return true;
+    }
+
+    double *IntrinsicBase::ParamsAddress() {
+        return nullptr;
+    }
+
+    const double *IntrinsicBase::ParamsAddress() const {
+        return nullptr;
+    }
+
+    std::size_t IntrinsicBase::ParamsSize() const {
+        return 0;
+    }
+
+    void IntrinsicBase::UpdateDerived() {}
+
+    Mat2Xd IntrinsicBase::Residuals(const Mat3Xd &X, const Mat2Xd &x, bool ignoreDisto) const {
+        Mat2Xd r = this->ProjectPoints(X, ignoreDisto);
+        SimdDispatch::Kernels().residuals(x.data(), r.data(), r.cols());
+        return r;
+    }
+
     bool IntrinsicBase::HaveDisto() const {
         return false;
     }
@@ -38,9 +88,9 @@ namespace ns_veta {
         HashCombine(seed, static_cast<int>( this->GetType()));
         HashCombine(seed, imgWidth);
         HashCombine(seed, imgHeight);
-        const std::vector<double> params = this->GetParams();
-        for (const auto &param: params)
-            HashCombine(seed, param);
+        const double *params = this->ParamsAddress();
+        for (std::size_t i = 0; i < this->ParamsSize(); ++i)
+            HashCombine(seed, params[i]);
         return seed;
     }
 }
\ No newline at end of file
@@ -5,53 +5,118 @@
 #include <utility>
 
 #include "veta/camera/pinhole.h"
+#include "veta/simd.h"
 
 namespace ns_veta {
 
+    PinholeIntrinsic::PinholeIntrinsic() : IntrinsicBase() {}
+
+    PinholeIntrinsic::PinholeIntrinsic(unsigned int w, unsigned int h, double fx, double fy,
+                                       double ppx, double ppy)
+            : PinholeIntrinsic(w, h, fx, fy, ppx, ppy, {}) {}
+
     PinholeIntrinsic::PinholeIntrinsic(unsigned int w, unsigned int h, double fx, double fy,
-                                       double ppx, double ppy) : IntrinsicBase(w, h) {
-        K << fx, 0., ppx, 0., fy, ppy, 0., 0., 1.;
-        KInv = K.inverse();
+                                       double ppx, double ppy, std::initializer_list<double> disto)
+            : IntrinsicBase(w, h), params{fx, fy, ppx, ppy},
+              distoCount(std::min(disto.size(), MaxDistoCount)) {
+        std::copy_n(disto.begin(), distoCount, params.begin() + 4);
+        UpdateDerived();
     }
 
     PinholeIntrinsic::PinholeIntrinsic(unsigned int w, unsigned int h, Mat3d KMat)
-            : IntrinsicBase(w, h), K(std::move(KMat)) {
-        KInv = K.inverse();
-    }
+            : IntrinsicBase(w, h), params{KMat(0, 0), KMat(1, 1), KMat(0, 2), KMat(1, 2)}, skew(KMat(0, 1)) {}
 
     Eintrinsic PinholeIntrinsic::GetType() const {
         return PINHOLE_CAMERA;
     }
 
-    const Mat3d &PinholeIntrinsic::KMat() const {
+    Mat3d PinholeIntrinsic::KMat() const {
+        Mat3d K;
+        K << params[0], skew, params[2],
+                0.0, params[1], params[3],
+                0.0, 0.0, 1.0;
         return K;
     }
 
-    const Mat3d &PinholeIntrinsic::KInvMat() const {
+    Mat3d PinholeIntrinsic::KInvMat() const {
+        const double fx = params[0], fy = params[1], cx = params[2], cy = params[3];
+        // 'K' is upper triangular, invert it in closed form
+        Mat3d KInv;
+        KInv << 1.0 / fx, -skew / (fx * fy), (skew * cy - cx * fy) / (fx * fy),
+                0.0, 1.0 / fy, -cy / fy,
+                0.0, 0.0, 1.0;
         return KInv;
     }
 
     double PinholeIntrinsic::Focal() const {
-        return 0.5 * (K(0, 0) + K(1, 1));
+        return 0.5 * (params[0] + params[1]);
     }
 
     Vec2d PinholeIntrinsic::PrincipalPoint() const {
-        return {K(0, 2), K(1, 2)};
+        return {params[2], params[3]};
     }
 
     Mat3Xd PinholeIntrinsic::operator()(const Mat2Xd &points) const {
-        return (KInv * points.colwise().homogeneous()).colwise().normalized();
+        // minimum number of points undistorted by a worker thread, and the number of points per batch (kept
+        // small enough for the temporaries of 'RemoveDistoPoints' to stay in cache)
+        constexpr std::size_t minChunk = 1 << 13, batchSize = 1 << 10;
+        const Mat3d KInv = KInvMat();
+        Mat3Xd bearings(3, points.cols());
+        ParallelForRange(0, points.cols(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+            for (std::size_t begin = lo; begin < hi; begin += batchSize) {
+                const auto first = static_cast<Eigen::Index>(begin);
+                const auto size = static_cast<Eigen::Index>(std::min(batchSize, hi - begin));
+                auto block = bearings.middleCols(first, size);
+                // image plane to camera plane ('KInv' handles the skew)
+                block.topRows<2>() = (KInv.topLeftCorner<2, 2>() * points.middleCols(first, size)).colwise() +
+                                     KInv.topRightCorner<2, 1>();
+                if (this->HaveDisto()) {
+                    block.topRows<2>() = this->RemoveDistoPoints(block.topRows<2>());
+                }
+                block.row(2).setOnes();
+                block.colwise().normalize();
+            }
+        }, minChunk);
+        return bearings;
+    }
+
+    Mat2Xd PinholeIntrinsic::RemoveDistoPoints(const Mat2Xd &p) const {
+        if (!this->HaveDisto()) {
+            return p;
+        }
+        Mat2Xd u(2, p.cols());
+        for (Mat2Xd::Index i = 0; i < p.cols(); ++i) {
+            u.col(i) = this->RemoveDisto(p.col(i));
+        }
+        return u;
+    }
+
+    Mat2Xd PinholeIntrinsic::ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const {
+        if (!this->HaveDisto() || ignoreDisto) {
+            // no skew: x' = f * x + c, by the dispatched kernel
+            Mat2Xd x(2, X.cols());
+            SimdDispatch::Kernels().projectRadial(params.data(), 0, X.data(), x.data(), X.cols());
+            return x;
+        }
+        Mat2Xd x = X.colwise().hnormalized();
+        for (Mat2Xd::Index i = 0; i < x.cols(); ++i) {
+            x.col(i) = this->AddDisto(x.col(i));
+        }
+        // no skew: x' = f * x + c
+        x.row(0) = (x.row(0).array() * params[0] + params[2]).matrix();
+        x.row(1) = (x.row(1).array() * params[1] + params[3]).matrix();
+        return x;
     }
 
     Vec2d PinholeIntrinsic::CamToImg(const Vec2d &p) const {
-        double x = p(0) * FocalX() + K(0, 2);
-        double y = p(1) * FocalY() + K(1, 2);
+        double x = p(0) * FocalX() + params[2];
+        double y = p(1) * FocalY() + params[3];
         return {x, y};
     }
 
     Vec2d PinholeIntrinsic::ImgToCam(const Vec2d &p) const {
-        double x = (p(0) - K(0, 2)) / FocalX();
-        double y = (p(1) - K(1, 2)) / FocalY();
+        double x = (p(0) - params[2]) / FocalX();
+        double y = (p(1) - params[3]) / FocalY();
         return {x, y};
     }
 
@@ -72,23 +137,19 @@ namespace ns_veta {
     }
 
     Mat34d PinholeIntrinsic::GetProjectiveEquivalent(const Posed &RefToCam) const {
-        return K * (Mat34d() << RefToCam.Rotation().matrix(), RefToCam.Translation()).finished();
+        return KMat() * (Mat34d() << RefToCam.Rotation().matrix(), RefToCam.Translation()).finished();
     }
 
-    std::vector<double> PinholeIntrinsic::GetParams() const {
-        return {K(0, 0), K(1, 1), K(0, 2), K(1, 2)}; // fx, fy, ppx, ppy
+    double *PinholeIntrinsic::ParamsAddress() {
+        return params.data();
     }
 
-    bool PinholeIntrinsic::UpdateFromParams(const std::vector<double> &params) {
-        if (params.size() == 4) {
-            *this = PinholeIntrinsic(
-                    imgWidth, imgHeight,
-                    params[0], params[1], params[2], params[3] // fx, fy, ppx, ppy
-            );
-            return true;
-        } else {
-            return false;
-        }
+    const double *PinholeIntrinsic::ParamsAddress() const {
+        return params.data();
+    }
+
+    std::size_t PinholeIntrinsic::ParamsSize() const {
+        return 4 + distoCount;
     }
 
     std::vector<int> PinholeIntrinsic::SubsetParameterization(const IntrinsicParamType &parametrization) const {
@@ -127,32 +188,36 @@ namespace ns_veta {
     }
 
     double PinholeIntrinsic::FocalX() const {
-        return K(0, 0);
+        return params[0];
     }
 
     double PinholeIntrinsic::FocalY() const {
-        return K(1, 1);
+        return params[1];
     }
 
     Vec2d PinholeIntrinsic::FocalXY() const {
-        return {K(0, 0), K(1, 1)};
+        return {params[0], params[1]};
     }
 
     double *PinholeIntrinsic::FXAddress() {
-        return &K(0, 0);
+        return &params[0];
     }
 
     double *PinholeIntrinsic::FYAddress() {
-        return &K(1, 1);
+        return &params[1];
     }
 
     double *PinholeIntrinsic::CXAddress() {
-        return &K(0, 2);
+        return &params[2];
     }
 
-    double *PinholeIntrinsic::CYAddress() { return &K(1, 2); }
+    double *PinholeIntrinsic::CYAddress() { return &params[3]; }
 
     double *PinholeIntrinsic::DistCoeffAddress() {
-        return nullptr;
+        return distoCount != 0 ? params.data() + 4 : nullptr;
+    }
+
+    const double *PinholeIntrinsic::DistoParams() const {
+        return params.data() + 4;
     }
-    } // namespace ns_veta
\ No newline at end of file
+}
@@ -3,12 +3,13 @@
 //
 
 #include "veta/camera/pinhole_brown.h"
+#include "veta/simd.h"
 
 namespace ns_veta {
 
     PinholeIntrinsicBrownT2::PinholeIntrinsicBrownT2(int w, int h, double fx, double fy, double ppx, double ppy,
                                                      double k1, double k2, double k3, double t1, double t2)
-            : PinholeIntrinsic(w, h, fx, fy, ppx, ppy), params({k1, k2, k3, t1, t2}) {}
+            : PinholeIntrinsic(w, h, fx, fy, ppx, ppy, {k1, k2, k3, t1, t2}) {}
 
     Eintrinsic PinholeIntrinsicBrownT2::GetType() const {
         return PINHOLE_CAMERA_BROWN_T2;
@@ -19,45 +20,44 @@ namespace ns_veta {
     }
 
     Vec2d PinholeIntrinsicBrownT2::AddDisto(const Vec2d &p) const {
-        return (p + DistoFunction(params, p));
+        return (p + DistoFunction(DistoParams(), p));
     }
 
     Vec2d PinholeIntrinsicBrownT2::RemoveDisto(const Vec2d &p) const {
         const double epsilon = 1e-10; //criteria to stop the iteration
         Vec2d p_u = p;
 
-        Vec2d d = DistoFunction(params, p_u);
+        Vec2d d = DistoFunction(DistoParams(), p_u);
         while ((p_u + d - p).lpNorm<1>() > epsilon) //manhattan distance between the two points
         {
             p_u = p - d;
-            d = DistoFunction(params, p_u);
+            d = DistoFunction(DistoParams(), p_u);
         }
 
         return p_u;
     }
 
-    std::vector<double> PinholeIntrinsicBrownT2::GetParams() const {
-        std::vector<double> paramsVec = PinholeIntrinsic::GetParams();
-        paramsVec.insert(paramsVec.end(), std::begin(params), std::end(params));
-        return paramsVec;
-    }
-
-    double *PinholeIntrinsicBrownT2::DistCoeffAddress() {
-        return this->params.data();
+    Mat2Xd PinholeIntrinsicBrownT2::RemoveDistoPoints(const Mat2Xd &p) const {
+        Mat2Xd p_u(2, p.cols());
+        std::vector<unsigned char> converged(p.cols());
+        SimdDispatch::Kernels().removeBrownDisto(DistoParams(), p.data(), p_u.data(), converged.data(), p.cols());
+        // the points not converged, solved by the fixed point iteration of 'RemoveDisto'
+        for (Mat2Xd::Index i = 0; i < p.cols(); ++i) {
+            if (!converged[i]) {
+                p_u.col(i) = RemoveDisto(p.col(i));
+            }
+        }
+        return p_u;
     }
 
-    bool PinholeIntrinsicBrownT2::UpdateFromParams(const std::vector<double> &paramsVec) {
-        if (paramsVec.size() == 9) {
-            *this = PinholeIntrinsicBrownT2(
-                    static_cast<int>(imgWidth), static_cast<int>(imgHeight),
-                    paramsVec[0], paramsVec[1], paramsVec[2], paramsVec[3], // fx, fy, ppx, ppy
-                    paramsVec[4], paramsVec[5], paramsVec[6],               // k1, k2, k3
-                    paramsVec[7], paramsVec[8]                              // t1, t2
-            );
-            return true;
+    Mat2Xd PinholeIntrinsicBrownT2::ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const {
+        Mat2Xd x(2, X.cols());
+        if (ignoreDisto) {
+            SimdDispatch::Kernels().projectRadial(params.data(), 0, X.data(), x.data(), X.cols());
         } else {
-            return false;
+            SimdDispatch::Kernels().projectBrown(params.data(), X.data(), x.data(), X.cols());
         }
+        return x;
     }
 
     std::vector<int>
@@ -91,12 +91,11 @@ namespace ns_veta {
         return new class_type(*this);
     }
 
-    Vec2d PinholeIntrinsicBrownT2::DistoFunction(const std::vector<double> &params, const Vec2d &p) {
-        const double k1 = params[0], k2 = params[1], k3 = params[2], t1 = params[3], t2 = params[4];
+    Vec2d PinholeIntrinsicBrownT2::DistoFunction(const double *params, const Vec2d &p) {
+        const double t1 = params[3], t2 = params[4];
         const double r2 = p(0) * p(0) + p(1) * p(1);
-        const double r4 = r2 * r2;
-        const double r6 = r4 * r2;
-        const double k_diff = (k1 * r2 + k2 * r4 + k3 * r6);
+        // k1 * r2 + k2 * r4 + k3 * r6
+        const double k_diff = RadialPolynomial<3>(params, r2) - 1.0;
         const double t_x = t2 * (r2 + 2 * p(0) * p(0)) + 2 * t1 * p(0) * p(1);
         const double t_y = t1 * (r2 + 2 * p(1) * p(1)) + 2 * t2 * p(0) * p(1);
         return {p(0) * k_diff + t_x, p(1) * k_diff + t_y};
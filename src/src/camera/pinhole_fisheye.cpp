@@ -3,12 +3,13 @@
 //
 
 #include "veta/camera/pinhole_fisheye.h"
+#include "veta/simd.h"
 
 namespace ns_veta {
 
     PinholeIntrinsicFisheye::PinholeIntrinsicFisheye(int w, int h, double fx, double fy, double ppx, double ppy,
                                                      double k1, double k2, double k3, double k4)
-            : PinholeIntrinsic(w, h, fx, fy, ppx, ppy), params({k1, k2, k3, k4}) {}
+            : PinholeIntrinsic(w, h, fx, fy, ppx, ppy, {k1, k2, k3, k4}) {}
 
     Eintrinsic PinholeIntrinsicFisheye::GetType() const {
         return PINHOLE_CAMERA_FISHEYE;
@@ -20,19 +21,10 @@ namespace ns_veta {
 
     Vec2d PinholeIntrinsicFisheye::AddDisto(const Vec2d &p) const {
         const double eps = 1e-8;
-        const double k1 = params[0], k2 = params[1], k3 = params[2], k4 = params[3];
         const double r = std::hypot(p(0), p(1));
         const double theta = std::atan(r);
-        const double
-                theta2 = theta * theta,
-                theta3 = theta2 * theta,
-                theta4 = theta2 * theta2,
-                theta5 = theta4 * theta,
-                theta6 = theta3 * theta3,
-                theta7 = theta6 * theta,
-                theta8 = theta4 * theta4,
-                theta9 = theta8 * theta;
-        const double theta_dist = theta + k1 * theta3 + k2 * theta5 + k3 * theta7 + k4 * theta9;
+        // theta + k1 * theta^3 + k2 * theta^5 + k3 * theta^7 + k4 * theta^9
+        const double theta_dist = theta * RadialPolynomial<DistoCount>(DistoParams(), theta * theta);
         const double inv_r = r > eps ? 1.0 / r : 1.0;
         const double cdist = r > eps ? theta_dist * inv_r : 1.0;
         return p * cdist;
@@ -43,41 +35,30 @@ namespace ns_veta {
         double scale = 1.0;
         const double theta_dist = std::hypot(p(0), p(1));
         if (theta_dist > eps) {
+            const double *disto = DistoParams();
             double theta = theta_dist;
             for (int j = 0; j < 10; ++j) {
-                const double theta2 = theta * theta;
-                const double theta4 = theta2 * theta2;
-                const double theta6 = theta4 * theta2;
-                const double theta8 = theta6 * theta2;
-                theta = theta_dist / (1 + params[0] * theta2 + params[1] * theta4
-                                      + params[2] * theta6 + params[3] * theta8);
+                theta = theta_dist / RadialPolynomial<DistoCount>(disto, theta * theta);
             }
             scale = std::tan(theta) / theta_dist;
         }
         return p * scale;
     }
 
-    std::vector<double> PinholeIntrinsicFisheye::GetParams() const {
-        std::vector<double> paramsVec = PinholeIntrinsic::GetParams();
-        paramsVec.insert(paramsVec.end(), std::begin(params), std::end(params));
-        return paramsVec;
+    Mat2Xd PinholeIntrinsicFisheye::RemoveDistoPoints(const Mat2Xd &p) const {
+        Mat2Xd u(2, p.cols());
+        SimdDispatch::Kernels().removeFisheyeDisto(DistoParams(), p.data(), u.data(), p.cols());
+        return u;
     }
 
-    double *PinholeIntrinsicFisheye::DistCoeffAddress() {
-        return this->params.data();
-    }
-
-    bool PinholeIntrinsicFisheye::UpdateFromParams(const std::vector<double> &paramsVec) {
-        if (paramsVec.size() == 8) {
-            *this = PinholeIntrinsicFisheye(
-                    static_cast<int>(imgWidth), static_cast<int>(imgHeight),
-                    paramsVec[0], paramsVec[1], paramsVec[2], paramsVec[3], // fx, fy, ppx, ppy
-                    paramsVec[4], paramsVec[5], paramsVec[6], paramsVec[7]  // k1, k2, k3, k4
-            );
-            return true;
+    Mat2Xd PinholeIntrinsicFisheye::ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const {
+        Mat2Xd x(2, X.cols());
+        if (ignoreDisto) {
+            SimdDispatch::Kernels().projectRadial(params.data(), 0, X.data(), x.data(), X.cols());
         } else {
-            return false;
+            SimdDispatch::Kernels().projectFisheye(params.data(), X.data(), x.data(), X.cols());
         }
+        return x;
     }
 
     std::vector<int>
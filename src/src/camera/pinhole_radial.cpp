@@ -3,6 +3,7 @@
 //
 
 #include "veta/camera/pinhole_radial.h"
+#include "veta/simd.h"
 
 namespace ns_veta {
 
@@ -19,10 +20,8 @@ namespace ns_veta {
     }
 
     Vec2d PinholeIntrinsicRadialK1::AddDisto(const Vec2d &p) const {
-        const double k1 = params[0];
-
         const double r2 = p(0) * p(0) + p(1) * p(1);
-        const double r_coeff = (1. + k1 * r2);
+        const double r_coeff = RadialPolynomial<DistoCount>(DistoParams(), r2); // 1 + k1 * r2
 
         return (p * r_coeff);
     }
@@ -32,31 +31,31 @@ namespace ns_veta {
         // Minimize disto(radius(p')^2) == actual Squared(radius(p))
 
         const double r2 = p(0) * p(0) + p(1) * p(1);
-        const double radius = (r2 == 0) ? 1. : ::sqrt(BisectionRadiusSolve(params, r2, DistoFunctor) / r2);
+        const double radius = (r2 == 0) ? 1. : ::sqrt(BisectionRadiusSolve(DistoParams(), r2, DistoFunctor) / r2);
         return radius * p;
     }
 
-    std::vector<double> PinholeIntrinsicRadialK1::GetParams() const {
-        std::vector<double> paramsVec = PinholeIntrinsic::GetParams();
-        paramsVec.insert(paramsVec.end(), std::begin(params), std::end(params));
-        return paramsVec;
-    }
-
-    double *PinholeIntrinsicRadialK1::DistCoeffAddress() {
-        return this->params.data();
-    }
-
-    bool PinholeIntrinsicRadialK1::UpdateFromParams(const std::vector<double> &paramsVec) {
-        if (paramsVec.size() == 5) {
-            *this = PinholeIntrinsicRadialK1(
-                    static_cast<int>(imgWidth), static_cast<int>(imgHeight),
-                    paramsVec[0], paramsVec[1], paramsVec[2], paramsVec[3], // fx, fy, ppx, ppy
-                    paramsVec[4]                                            // k1
-            );
-            return true;
-        } else {
-            return false;
+    Mat2Xd PinholeIntrinsicRadialK1::ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const {
+        Mat2Xd x(2, X.cols());
+        SimdDispatch::Kernels().projectRadial(
+                params.data(), ignoreDisto ? 0 : DistoCount, X.data(), x.data(), X.cols()
+        );
+        return x;
+    }
+
+    Mat2Xd PinholeIntrinsicRadialK1::RemoveDistoPoints(const Mat2Xd &p) const {
+        Mat2Xd u(2, p.cols());
+        std::vector<unsigned char> converged(p.cols());
+        SimdDispatch::Kernels().removeRadialDisto(
+                DistoParams(), DistoCount, p.data(), u.data(), converged.data(), p.cols()
+        );
+        // the points where Newton did not reach the increasing branch of the polynomial, solved by bisection
+        for (Mat2Xd::Index i = 0; i < p.cols(); ++i) {
+            if (!converged[i]) {
+                u.col(i) = RemoveDisto(p.col(i));
+            }
         }
+        return u;
     }
 
     std::vector<int>
@@ -90,9 +89,8 @@ namespace ns_veta {
         return new class_type(*this);
     }
 
-    double PinholeIntrinsicRadialK1::DistoFunctor(const std::vector<double> &params, double r2) {
-        const double &k1 = params[0];
-        return r2 * Square(1. + r2 * k1);
+    double PinholeIntrinsicRadialK1::DistoFunctor(const double *params, double r2) {
+        return r2 * Square(RadialPolynomial<DistoCount>(params, r2));
     }
 
     PinholeIntrinsicRadialK1::Ptr
@@ -113,12 +111,9 @@ namespace ns_veta {
     }
 
     Vec2d PinholeIntrinsicRadialK3::AddDisto(const Vec2d &p) const {
-        const double &k1 = params[0], &k2 = params[1], &k3 = params[2];
-
         const double r2 = p(0) * p(0) + p(1) * p(1);
-        const double r4 = r2 * r2;
-        const double r6 = r4 * r2;
-        const double r_coeff = (1. + k1 * r2 + k2 * r4 + k3 * r6);
+        // 1 + k1 * r2 + k2 * r4 + k3 * r6
+        const double r_coeff = RadialPolynomial<DistoCount>(DistoParams(), r2);
 
         return (p * r_coeff);
     }
@@ -128,27 +123,31 @@ namespace ns_veta {
         // Minimize disto(radius(p')^2) == actual Squared(radius(p))
 
         const double r2 = p(0) * p(0) + p(1) * p(1);
-        const double radius = (r2 == 0) ? 1. : ::sqrt(BisectionRadiusSolve(params, r2, DistoFunctor) / r2);
+        const double radius = (r2 == 0) ? 1. : ::sqrt(BisectionRadiusSolve(DistoParams(), r2, DistoFunctor) / r2);
         return radius * p;
     }
 
-    std::vector<double> PinholeIntrinsicRadialK3::GetParams() const {
-        std::vector<double> paramsVec = PinholeIntrinsic::GetParams();
-        paramsVec.insert(paramsVec.end(), std::begin(params), std::end(params));
-        return paramsVec;
-    }
-
-    bool PinholeIntrinsicRadialK3::UpdateFromParams(const std::vector<double> &paramsVec) {
-        if (paramsVec.size() == 7) {
-            *this = PinholeIntrinsicRadialK3(
-                    static_cast<int>(imgWidth), static_cast<int>(imgHeight),
-                    paramsVec[0], paramsVec[1], paramsVec[2], paramsVec[3], // fx, fy, ppx, ppy
-                    paramsVec[4], paramsVec[5], paramsVec[6]                // k1, k2, k3
-            );
-            return true;
-        } else {
-            return false;
+    Mat2Xd PinholeIntrinsicRadialK3::ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const {
+        Mat2Xd x(2, X.cols());
+        SimdDispatch::Kernels().projectRadial(
+                params.data(), ignoreDisto ? 0 : DistoCount, X.data(), x.data(), X.cols()
+        );
+        return x;
+    }
+
+    Mat2Xd PinholeIntrinsicRadialK3::RemoveDistoPoints(const Mat2Xd &p) const {
+        Mat2Xd u(2, p.cols());
+        std::vector<unsigned char> converged(p.cols());
+        SimdDispatch::Kernels().removeRadialDisto(
+                DistoParams(), DistoCount, p.data(), u.data(), converged.data(), p.cols()
+        );
+        // the points where Newton did not reach the increasing branch of the polynomial, solved by bisection
+        for (Mat2Xd::Index i = 0; i < p.cols(); ++i) {
+            if (!converged[i]) {
+                u.col(i) = RemoveDisto(p.col(i));
+            }
         }
+        return u;
     }
 
     std::vector<int>
@@ -182,9 +181,8 @@ namespace ns_veta {
         return new class_type(*this);
     }
 
-    double PinholeIntrinsicRadialK3::DistoFunctor(const std::vector<double> &params, double r2) {
-        const double &k1 = params[0], &k2 = params[1], &k3 = params[2];
-        return r2 * Square(1. + r2 * (k1 + r2 * (k2 + r2 * k3)));
+    double PinholeIntrinsicRadialK3::DistoFunctor(const double *params, double r2) {
+        return r2 * Square(RadialPolynomial<DistoCount>(params, r2));
     }
 
     PinholeIntrinsicRadialK3::Ptr
@@ -3,6 +3,7 @@
 //
 
 #include "veta/camera/spherical.h"
+#include "veta/fast_math.h"
 
 namespace ns_veta {
 
@@ -34,15 +35,28 @@ namespace ns_veta {
     }
 
     Mat3Xd IntrinsicSpherical::operator()(const Mat2Xd &points) const {
+        // minimum number of points handled by a worker thread, and the number of points per batch
+        constexpr std::size_t minChunk = 1 << 13, batchSize = 1 << 10;
+        const double scale = 2 * M_PI / std::max(Width(), Height());
         Mat3Xd bearing(3, points.cols());
-        for (Mat2Xd::Index i(0); i < points.cols(); ++i) {
-            const Vec2d uv = ImgToCam(points.col(i));
-
-            const double lon = uv.x() * 2 * M_PI;
-            const double lat = -uv.y() * 2 * M_PI;
-
-            bearing.col(i) << std::cos(lat) * std::sin(lon), -std::sin(lat), std::cos(lat) * std::cos(lon);
-        }
+        ParallelForRange(0, points.cols(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+            Eigen::ArrayXd sinLon, cosLon, sinLat, cosLat;
+            for (std::size_t begin = lo; begin < hi; begin += batchSize) {
+                const auto first = static_cast<Eigen::Index>(begin);
+                const auto size = static_cast<Eigen::Index>(std::min(batchSize, hi - begin));
+                const auto uv = points.middleCols(first, size).array();
+                // image plane to longitude and latitude
+                const Eigen::ArrayXd lon = (uv.row(0).transpose() - Width() / 2.0) * scale;
+                const Eigen::ArrayXd lat = (uv.row(1).transpose() - Height() / 2.0) * -scale;
+                FastMath::SinCos(lon, sinLon, cosLon);
+                FastMath::SinCos(lat, sinLat, cosLat);
+
+                auto block = bearing.middleCols(first, size).array();
+                block.row(0) = (cosLat * sinLon).transpose();
+                block.row(1) = -sinLat.transpose();
+                block.row(2) = (cosLat * cosLon).transpose();
+            }
+        }, minChunk);
         return bearing;
     }
 
@@ -53,6 +67,28 @@ namespace ns_veta {
         return CamToImg({lon / (2 * M_PI), -lat / (2 * M_PI)});
     }
 
+    Mat2Xd IntrinsicSpherical::ProjectPoints(const Mat3Xd &X, bool ignoreDisto) const {
+        constexpr std::size_t minChunk = 1 << 13, batchSize = 1 << 10;
+        const double size(std::max(Width(), Height()));
+        Mat2Xd x(2, X.cols());
+        ParallelForRange(0, X.cols(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+            for (std::size_t begin = lo; begin < hi; begin += batchSize) {
+                const auto first = static_cast<Eigen::Index>(begin);
+                const auto count = static_cast<Eigen::Index>(std::min(batchSize, hi - begin));
+                const auto p = X.middleCols(first, count).array();
+                const Eigen::ArrayXd px = p.row(0).transpose(), py = p.row(1).transpose(), pz = p.row(2).transpose();
+                // horizontal normalization of the X-Z component, and tilt angle
+                const Eigen::ArrayXd lon = FastMath::Atan2(px, pz);
+                const Eigen::ArrayXd lat = FastMath::Atan2(-py, (px.square() + pz.square()).sqrt());
+                // de-normalization (angle to pixel value)
+                auto block = x.middleCols(first, count).array();
+                block.row(0) = (lon * (size / (2 * M_PI)) + Width() / 2.0).transpose();
+                block.row(1) = (lat * (-size / (2 * M_PI)) + Height() / 2.0).transpose();
+            }
+        }, minChunk);
+        return x;
+    }
+
     bool IntrinsicSpherical::HaveDisto() const { return false; }
 
     Vec2d IntrinsicSpherical::AddDisto(const Vec2d &p) const { return p; }
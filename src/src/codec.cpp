@@ -0,0 +1,306 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/codec.h"
+#include <cstring>
+
+namespace ns_veta {
+
+    // ----------
+    // ByteWriter
+    // ----------
+
+    const std::vector<uint8_t> &ByteWriter::Buffer() const {
+        return buffer;
+    }
+
+    std::vector<uint8_t> &ByteWriter::Buffer() {
+        return buffer;
+    }
+
+    std::size_t ByteWriter::Size() const {
+        return buffer.size();
+    }
+
+    void ByteWriter::Clear() {
+        buffer.clear();
+    }
+
+    void ByteWriter::PutByte(uint8_t v) {
+        buffer.push_back(v);
+    }
+
+    void ByteWriter::PutBytes(const uint8_t *data, std::size_t size) {
+        buffer.insert(buffer.end(), data, data + size);
+    }
+
+    void ByteWriter::PutVarUInt(uint64_t v) {
+        while (v >= 0x80) {
+            buffer.push_back(static_cast<uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        buffer.push_back(static_cast<uint8_t>(v));
+    }
+
+    void ByteWriter::PutVarInt(int64_t v) {
+        PutVarUInt((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+
+    // ----------
+    // ByteReader
+    // ----------
+
+    ByteReader::ByteReader(const uint8_t *data, std::size_t size) : cur(data), end(data + size) {}
+
+    bool ByteReader::AtEnd() const {
+        return cur == end;
+    }
+
+    std::size_t ByteReader::Remaining() const {
+        return end - cur;
+    }
+
+    uint8_t ByteReader::GetByte() {
+        if (cur == end) {
+            throw std::runtime_error("unexpected end of the encoded data");
+        }
+        return *cur++;
+    }
+
+    const uint8_t *ByteReader::GetBytes(std::size_t size) {
+        if (Remaining() < size) {
+            throw std::runtime_error("unexpected end of the encoded data");
+        }
+        const uint8_t *data = cur;
+        cur += size;
+        return data;
+    }
+
+    uint64_t ByteReader::GetVarUInt() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = GetByte();
+            v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return v;
+            }
+        }
+        throw std::runtime_error("malformed variable length integer");
+    }
+
+    int64_t ByteReader::GetVarInt() {
+        const uint64_t v = GetVarUInt();
+        return static_cast<int64_t>((v >> 1) ^ (~(v & 1) + 1));
+    }
+
+    // -----------
+    // xor doubles
+    // -----------
+
+    void PutXorDoubles(ByteWriter &writer, const double *values, std::size_t count) {
+        uint64_t prev = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            uint64_t bits;
+            std::memcpy(&bits, values + i, sizeof(bits));
+            uint64_t delta = bits ^ prev;
+            prev = bits;
+            if (delta == 0) {
+                // lead = 8, nbytes = 0
+                writer.PutByte(0x80);
+                continue;
+            }
+            int lead = 0, trail = 0;
+            while (!(delta >> (56 - 8 * lead) & 0xFF)) { ++lead; }
+            while (!(delta >> (8 * trail) & 0xFF)) { ++trail; }
+            const int nbytes = 8 - lead - trail;
+            writer.PutByte(static_cast<uint8_t>(lead << 4 | nbytes));
+            delta >>= 8 * trail;
+            for (int j = 0; j < nbytes; ++j, delta >>= 8) {
+                writer.PutByte(static_cast<uint8_t>(delta));
+            }
+        }
+    }
+
+    void GetXorDoubles(ByteReader &reader, double *values, std::size_t count) {
+        uint64_t prev = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const uint8_t control = reader.GetByte();
+            const int lead = control >> 4, nbytes = control & 0x0F;
+            if (lead + nbytes > 8) {
+                throw std::runtime_error("malformed xor-compressed double");
+            }
+            const int trail = 8 - lead - nbytes;
+            uint64_t delta = 0;
+            const uint8_t *bytes = reader.GetBytes(nbytes);
+            for (int j = 0; j < nbytes; ++j) {
+                delta |= static_cast<uint64_t>(bytes[j]) << (8 * j);
+            }
+            // a shift by 64 is undefined, 'trail' is 8 only for a null delta
+            prev ^= trail < 8 ? delta << (8 * trail) : 0;
+            std::memcpy(values + i, &prev, sizeof(prev));
+        }
+    }
+
+    // --------
+    // LZ codec
+    // --------
+
+    namespace {
+        constexpr std::size_t LzMinMatch = 4;
+        constexpr std::size_t LzMaxOffset = 0xFFFF;
+        constexpr int LzHashBits = 16;
+
+        inline uint32_t Read32(const uint8_t *p) {
+            uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        inline uint32_t LzHash(uint32_t v) {
+            return (v * 2654435761u) >> (32 - LzHashBits);
+        }
+
+        inline void PutLength(std::vector<uint8_t> &out, std::size_t len) {
+            while (len >= 0xFF) {
+                out.push_back(0xFF);
+                len -= 0xFF;
+            }
+            out.push_back(static_cast<uint8_t>(len));
+        }
+
+        inline void PutSequence(std::vector<uint8_t> &out, const uint8_t *literals, std::size_t litLen,
+                                std::size_t offset, std::size_t matchLen) {
+            const std::size_t litNibble = std::min<std::size_t>(litLen, 15);
+            const std::size_t matchNibble = matchLen ? std::min<std::size_t>(matchLen - LzMinMatch, 15) : 0;
+            out.push_back(static_cast<uint8_t>(litNibble << 4 | matchNibble));
+            if (litNibble == 15) {
+                PutLength(out, litLen - 15);
+            }
+            out.insert(out.end(), literals, literals + litLen);
+            if (matchLen) {
+                out.push_back(static_cast<uint8_t>(offset));
+                out.push_back(static_cast<uint8_t>(offset >> 8));
+                if (matchNibble == 15) {
+                    PutLength(out, matchLen - LzMinMatch - 15);
+                }
+            }
+        }
+
+        inline std::size_t GetLength(ByteReader &reader, std::size_t len) {
+            uint8_t byte;
+            do {
+                byte = reader.GetByte();
+                len += byte;
+            } while (byte == 0xFF);
+            return len;
+        }
+    }
+
+    std::vector<uint8_t> LzCompress(const uint8_t *data, std::size_t size) {
+        std::vector<uint8_t> out;
+        out.reserve(size / 2 + 16);
+        // positions are stored plus one, zero marks an empty slot
+        std::vector<uint32_t> table(std::size_t(1) << LzHashBits, 0);
+
+        std::size_t anchor = 0, i = 0;
+        while (size >= LzMinMatch && i + LzMinMatch <= size) {
+            const uint32_t seq = Read32(data + i);
+            uint32_t &slot = table[LzHash(seq)];
+            const std::size_t cand = slot;
+            slot = static_cast<uint32_t>(i + 1);
+            if (cand && i + 1 - cand <= LzMaxOffset && Read32(data + cand - 1) == seq) {
+                const std::size_t ref = cand - 1;
+                std::size_t len = LzMinMatch;
+                while (i + len < size && data[ref + len] == data[i + len]) {
+                    ++len;
+                }
+                PutSequence(out, data + anchor, i - anchor, i - ref, len);
+                i += len;
+                anchor = i;
+            } else {
+                ++i;
+            }
+        }
+        // the last sequence only holds literals
+        PutSequence(out, data + anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    std::vector<uint8_t> LzDecompress(const uint8_t *data, std::size_t size, std::size_t rawSize) {
+        std::vector<uint8_t> out;
+        // 'rawSize' comes from the container, a byte of a sequence decodes to at most 255 bytes
+        out.reserve(std::min<std::size_t>(rawSize, size * 255 + LzMinMatch));
+        ByteReader reader(data, size);
+        while (!reader.AtEnd()) {
+            const uint8_t token = reader.GetByte();
+            std::size_t litLen = token >> 4;
+            if (litLen == 15) {
+                litLen = GetLength(reader, litLen);
+            }
+            if (out.size() + litLen > rawSize) {
+                throw std::runtime_error("lz block decodes to more bytes than expected");
+            }
+            const uint8_t *literals = reader.GetBytes(litLen);
+            out.insert(out.end(), literals, literals + litLen);
+            if (reader.AtEnd()) {
+                break;
+            }
+            const uint8_t *offsetBytes = reader.GetBytes(2);
+            const std::size_t offset = offsetBytes[0] | std::size_t(offsetBytes[1]) << 8;
+            std::size_t matchLen = token & 0x0F;
+            if (matchLen == 15) {
+                matchLen = GetLength(reader, matchLen);
+            }
+            matchLen += LzMinMatch;
+            if (offset == 0 || offset > out.size() || out.size() + matchLen > rawSize) {
+                throw std::runtime_error("malformed lz match");
+            }
+            // byte-wise copy, the match may overlap the bytes it produces
+            std::size_t from = out.size() - offset;
+            for (std::size_t j = 0; j < matchLen; ++j) {
+                out.push_back(out[from + j]);
+            }
+        }
+        if (out.size() != rawSize) {
+            throw std::runtime_error("lz block decodes to less bytes than expected");
+        }
+        return out;
+    }
+
+    // -------
+    // columns
+    // -------
+
+    void PutColumn(ByteWriter &writer, const std::vector<uint8_t> &column) {
+        writer.PutVarUInt(column.size());
+        std::vector<uint8_t> packed = LzCompress(column.data(), column.size());
+        if (packed.size() < column.size()) {
+            writer.PutByte(1);
+            writer.PutVarUInt(packed.size());
+            writer.PutBytes(packed.data(), packed.size());
+        } else {
+            writer.PutByte(0);
+            writer.PutVarUInt(column.size());
+            writer.PutBytes(column.data(), column.size());
+        }
+    }
+
+    std::vector<uint8_t> GetColumn(ByteReader &reader) {
+        const uint64_t rawSize = reader.GetVarUInt();
+        const uint8_t codec = reader.GetByte();
+        const uint64_t storedSize = reader.GetVarUInt();
+        const uint8_t *bytes = reader.GetBytes(storedSize);
+        switch (codec) {
+            case 0:
+                if (storedSize != rawSize) {
+                    throw std::runtime_error("malformed raw column");
+                }
+                return {bytes, bytes + storedSize};
+            case 1:
+                return LzDecompress(bytes, storedSize, rawSize);
+            default:
+                throw std::runtime_error("unknown column codec '" + std::to_string(codec) + "'");
+        }
+    }
+}
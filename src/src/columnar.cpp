@@ -0,0 +1,310 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/columnar.h"
+#include <cstring>
+
+namespace ns_veta {
+
+    namespace {
+        void WriteVarUInt(std::ostream &stream, uint64_t v) {
+            ByteWriter writer;
+            writer.PutVarUInt(v);
+            stream.write(reinterpret_cast<const char *>(writer.Buffer().data()),
+                         static_cast<std::streamsize>(writer.Size()));
+        }
+
+        uint64_t ReadVarUInt(std::istream &stream) {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const int byte = stream.get();
+                if (byte == std::char_traits<char>::eof()) {
+                    throw std::runtime_error("unexpected end of the '.vetac' file");
+                }
+                v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return v;
+                }
+            }
+            throw std::runtime_error("malformed variable length integer");
+        }
+    }
+
+    std::vector<uint8_t> EncodeLandmarkBlock(Landmarks::const_iterator begin, Landmarks::const_iterator end) {
+        ByteWriter ids, xs[3], colors, obsCount, obsView, obsFeat, obsX, obsY;
+        std::vector<double> coords[3], pixels[2];
+
+        IndexT prevId = 0;
+        uint64_t prevFeat = 0;
+        std::size_t count = 0;
+        for (auto it = begin; it != end; ++it, ++count) {
+            const auto &[lmId, lm] = *it;
+            // keys of the map are sorted, the first delta is from zero
+            ids.PutVarUInt(lmId - prevId);
+            prevId = lmId;
+            for (int i = 0; i < 3; ++i) {
+                coords[i].push_back(lm.X(i));
+            }
+            obsCount.PutVarUInt(lm.obs.size());
+            IndexT prevView = 0;
+            for (const auto &[viewId, ob]: lm.obs) {
+                obsView.PutVarUInt(viewId - prevView);
+                prevView = viewId;
+                // shift by one so that the undefined feature id wraps to zero
+                const uint64_t feat = ob.FeatId() + 1;
+                obsFeat.PutVarInt(static_cast<int64_t>(feat - prevFeat));
+                prevFeat = feat;
+                pixels[0].push_back(ob.x(0));
+                pixels[1].push_back(ob.x(1));
+            }
+        }
+
+        // run-length encoded colors
+        for (auto it = begin; it != end;) {
+            const Landmark::Color color = it->second.color;
+            uint64_t run = 0;
+            for (; it != end && it->second.color == color; ++it) {
+                ++run;
+            }
+            colors.PutVarUInt(run);
+            colors.PutBytes(color.data(), 3);
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            PutXorDoubles(xs[i], coords[i].data(), coords[i].size());
+        }
+        PutXorDoubles(obsX, pixels[0].data(), pixels[0].size());
+        PutXorDoubles(obsY, pixels[1].data(), pixels[1].size());
+
+        ByteWriter block;
+        block.PutVarUInt(count);
+        for (const ByteWriter *column: {&ids, &xs[0], &xs[1], &xs[2], &colors,
+                                        &obsCount, &obsView, &obsFeat, &obsX, &obsY}) {
+            PutColumn(block, column->Buffer());
+        }
+        return std::move(block.Buffer());
+    }
+
+    void DecodeLandmarkBlock(const uint8_t *data, std::size_t size, Landmarks &structure) {
+        ByteReader block(data, size);
+        const uint64_t count = block.GetVarUInt();
+        // each landmark takes at least one byte of its block, which bounds the allocations below
+        if (count > size) {
+            throw std::runtime_error("malformed columnar block");
+        }
+
+        std::vector<uint8_t> columns[10];
+        for (auto &column: columns) {
+            column = GetColumn(block);
+        }
+        ByteReader ids(columns[0].data(), columns[0].size());
+        ByteReader colors(columns[4].data(), columns[4].size());
+        ByteReader obsCount(columns[5].data(), columns[5].size());
+        ByteReader obsView(columns[6].data(), columns[6].size());
+        ByteReader obsFeat(columns[7].data(), columns[7].size());
+
+        std::vector<double> coords[3];
+        for (int i = 0; i < 3; ++i) {
+            ByteReader reader(columns[1 + i].data(), columns[1 + i].size());
+            coords[i].resize(count);
+            GetXorDoubles(reader, coords[i].data(), count);
+        }
+
+        // the number of observations is required to decode the pixel columns
+        std::vector<uint64_t> counts(count);
+        uint64_t totalObs = 0;
+        // each observation takes at least one byte of each pixel column, which bounds the allocations below
+        const uint64_t maxObs = std::min(columns[8].size(), columns[9].size());
+        for (auto &c: counts) {
+            c = obsCount.GetVarUInt();
+            if (c > maxObs - totalObs) {
+                throw std::runtime_error("malformed columnar block");
+            }
+            totalObs += c;
+        }
+        std::vector<double> pixels[2];
+        for (int i = 0; i < 2; ++i) {
+            ByteReader reader(columns[8 + i].data(), columns[8 + i].size());
+            pixels[i].resize(totalObs);
+            GetXorDoubles(reader, pixels[i].data(), totalObs);
+        }
+
+        IndexT prevId = 0;
+        uint64_t prevFeat = 0, obsIdx = 0, run = 0;
+        Landmark::Color color = Landmark::Color::Zero();
+        for (uint64_t i = 0; i < count; ++i) {
+            const IndexT lmId = prevId + ids.GetVarUInt();
+            prevId = lmId;
+            if (run == 0) {
+                run = colors.GetVarUInt();
+                std::memcpy(color.data(), colors.GetBytes(3), 3);
+            }
+            --run;
+
+            Landmark lm(Vec3d(coords[0][i], coords[1][i], coords[2][i]), {}, color);
+            IndexT prevView = 0;
+            for (uint64_t j = 0; j < counts[i]; ++j, ++obsIdx) {
+                const IndexT viewId = prevView + obsView.GetVarUInt();
+                prevView = viewId;
+                const uint64_t feat = prevFeat + static_cast<uint64_t>(obsFeat.GetVarInt());
+                prevFeat = feat;
+                lm.obs.emplace_hint(lm.obs.end(), viewId,
+                                    Observation(Vec2d(pixels[0][obsIdx], pixels[1][obsIdx]), feat - 1));
+            }
+            structure.emplace_hint(structure.end(), lmId, std::move(lm));
+        }
+    }
+
+    bool SaveColumnar(const Veta &veta, const std::string &filename, Veta::Parts flag) {
+        std::ofstream stream(filename, std::ios::binary | std::ios::out);
+        if (!stream) {
+            return false;
+        }
+        stream.write(ColumnarFormat::Magic, sizeof(ColumnarFormat::Magic));
+        {
+            cereal::PortableBinaryOutputArchive archive(stream);
+            const std::string version = "0.1";
+            archive(cereal::make_nvp("veta_version", version));
+
+            if (Veta::IsPartsWith(Veta::VIEWS, flag))
+                archive(cereal::make_nvp("views", veta.views));
+            else
+                archive(cereal::make_nvp("views", Views()));
+
+            if (Veta::IsPartsWith(Veta::INTRINSICS, flag))
+                archive(cereal::make_nvp("intrinsics", veta.intrinsics));
+            else
+                archive(cereal::make_nvp("intrinsics", Intrinsics()));
+
+            if (Veta::IsPartsWith(Veta::EXTRINSICS, flag))
+                archive(cereal::make_nvp("extrinsics", veta.poses));
+            else
+                archive(cereal::make_nvp("extrinsics", Poses()));
+        }
+
+        // structure, block by block
+        const bool withStructure = Veta::IsPartsWith(Veta::STRUCTURE, flag);
+        const std::size_t lmCount = withStructure ? veta.structure.size() : 0;
+        const std::size_t blockCount = (lmCount + ColumnarFormat::BlockSize - 1) / ColumnarFormat::BlockSize;
+        WriteVarUInt(stream, lmCount);
+        WriteVarUInt(stream, blockCount);
+        auto it = veta.structure.cbegin();
+        for (std::size_t b = 0; b < blockCount; ++b) {
+            auto blockEnd = it;
+            std::advance(blockEnd, std::min(ColumnarFormat::BlockSize, lmCount - b * ColumnarFormat::BlockSize));
+            const std::vector<uint8_t> block = EncodeLandmarkBlock(it, blockEnd);
+            WriteVarUInt(stream, block.size());
+            stream.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size()));
+            it = blockEnd;
+        }
+        const bool bOk = static_cast<bool>(stream);
+        stream.close();
+        return bOk;
+    }
+
+    bool LoadColumnar(Veta &veta, const std::string &filename, Veta::Parts flag) {
+        std::ifstream stream(filename, std::ios::binary | std::ios::in);
+        if (!stream) {
+            return false;
+        }
+        try {
+            // the nested containers (e.g. the observations) are allocated from the resource of the scene
+            const ScopedResource scope(veta.Resource());
+            char magic[sizeof(ColumnarFormat::Magic)];
+            stream.read(magic, sizeof(magic));
+            if (!stream || std::memcmp(magic, ColumnarFormat::Magic, sizeof(magic)) != 0) {
+                std::cerr << "The file '" << filename << "' is not a '.vetac' file";
+                return false;
+            }
+            {
+                cereal::PortableBinaryInputArchive archive(stream);
+                std::string version;
+                archive(cereal::make_nvp("veta_version", version));
+                if (version != "0.1") {
+                    throw cereal::Exception("unsupported '.vetac' version '" + version + "'");
+                }
+
+                // binary archives require to read all the members, unused ones go to temporary objects
+                Views views;
+                archive(cereal::make_nvp("views", Veta::IsPartsWith(Veta::VIEWS, flag) ? veta.views : views));
+                Intrinsics intrinsics;
+                archive(cereal::make_nvp(
+                        "intrinsics", Veta::IsPartsWith(Veta::INTRINSICS, flag) ? veta.intrinsics : intrinsics
+                ));
+                Poses poses;
+                archive(cereal::make_nvp("extrinsics", Veta::IsPartsWith(Veta::EXTRINSICS, flag) ? veta.poses : poses));
+            }
+
+            if (Veta::IsPartsWith(Veta::STRUCTURE, flag)) {
+                // the sizes read from the file are bounded by the rest of the file before any allocation
+                const std::streampos structureBegin = stream.tellg();
+                stream.seekg(0, std::ios::end);
+                const std::streampos fileEnd = stream.tellg();
+                stream.seekg(structureBegin);
+                const auto remaining = [&stream, fileEnd]() {
+                    return static_cast<uint64_t>(fileEnd - stream.tellg());
+                };
+
+                const uint64_t lmCount = ReadVarUInt(stream);
+                const uint64_t blockCount = ReadVarUInt(stream);
+                if (blockCount > remaining()) {
+                    throw std::runtime_error("unexpected end of the '.vetac' file");
+                }
+                std::vector<std::vector<uint8_t>> blocks(blockCount);
+                for (auto &block: blocks) {
+                    const uint64_t size = ReadVarUInt(stream);
+                    if (size > remaining()) {
+                        throw std::runtime_error("unexpected end of the '.vetac' file");
+                    }
+                    block.resize(size);
+                    stream.read(reinterpret_cast<char *>(block.data()), static_cast<std::streamsize>(block.size()));
+                    if (!stream) {
+                        throw std::runtime_error("unexpected end of the '.vetac' file");
+                    }
+                }
+
+                // the blocks are decoded in parallel, unless the memory resource of the scene is not thread-safe
+                const std::shared_ptr<std::pmr::memory_resource> &resource = veta.Resource();
+                const auto arena = std::dynamic_pointer_cast<ArenaResource>(resource);
+                const bool parallel = !resource || (arena && arena->Synchronized());
+                std::vector<Landmarks> parts;
+                parts.reserve(blocks.size());
+                for (std::size_t b = 0; b < blocks.size(); ++b) {
+                    parts.emplace_back(veta.structure.get_allocator());
+                }
+                if (parallel) {
+                    ParallelFor(0, blocks.size(), [&](std::size_t b) {
+                        // the observations of the landmarks are allocated from the resource of the scene
+                        const ScopedResource workerScope(resource);
+                        DecodeLandmarkBlock(blocks[b].data(), blocks[b].size(), parts[b]);
+                        std::vector<uint8_t>().swap(blocks[b]);
+                    }, 1);
+                } else {
+                    for (std::size_t b = 0; b < blocks.size(); ++b) {
+                        DecodeLandmarkBlock(blocks[b].data(), blocks[b].size(), parts[b]);
+                    }
+                }
+
+                // the blocks hold increasing landmark ids, their nodes are moved in order
+                veta.structure.clear();
+                for (auto &part: parts) {
+                    while (!part.empty()) {
+                        veta.structure.insert(veta.structure.end(), part.extract(part.begin()));
+                    }
+                }
+                if (veta.structure.size() != lmCount) {
+                    throw std::runtime_error("the number of landmarks of the '.vetac' file does not match its blocks");
+                }
+            }
+        }
+        catch (const std::exception &e) {
+            // 'cereal::Exception' is a 'std::runtime_error' as well
+            std::cerr << e.what();
+            stream.close();
+            return false;
+        }
+        stream.close();
+        return true;
+    }
+}
@@ -0,0 +1,98 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/compact_ids.h"
+#include "veta/utils.hpp"
+
+namespace ns_veta {
+
+    namespace {
+        /**
+        * @brief renumber the keys of a map to their rank, by moving the nodes
+        * @return the previous keys, indexed by the new ones (sorted)
+        */
+        template<class MapType>
+        std::vector<IndexT> RenumberKeys(MapType &map) {
+            std::vector<IndexT> oldIds;
+            oldIds.reserve(map.size());
+            // nodes are only moved between maps of equal allocators
+            MapType renumbered(map.get_allocator());
+            while (!map.empty()) {
+                auto node = map.extract(map.begin());
+                oldIds.push_back(node.key());
+                node.key() = static_cast<IndexT>(oldIds.size() - 1);
+                renumbered.insert(renumbered.end(), std::move(node));
+            }
+            map = std::move(renumbered);
+            return oldIds;
+        }
+
+        IndexT ToNewId(const std::vector<IndexT> &oldIds, IndexT oldId) {
+            auto iter = std::lower_bound(oldIds.cbegin(), oldIds.cend(), oldId);
+            if (iter == oldIds.cend() || *iter != oldId) {
+                return UndefinedIndexT;
+            }
+            return static_cast<IndexT>(iter - oldIds.cbegin());
+        }
+
+        HashMap<IndexT, IndexT> ToTable(const std::vector<IndexT> &oldIds) {
+            HashMap<IndexT, IndexT> table;
+            for (std::size_t i = 0; i < oldIds.size(); ++i) {
+                table.emplace_hint(table.end(), oldIds[i], static_cast<IndexT>(i));
+            }
+            return table;
+        }
+    }
+
+    IdMap CompactIds(Veta &veta) {
+        const std::vector<IndexT> viewIds = RenumberKeys(veta.views);
+        const std::vector<IndexT> poseIds = RenumberKeys(veta.poses);
+        const std::vector<IndexT> intrinsicIds = RenumberKeys(veta.intrinsics);
+        const std::vector<IndexT> landmarkIds = RenumberKeys(veta.structure);
+
+        // views
+        std::vector<std::pair<IndexT, View::Ptr *>> views;
+        views.reserve(veta.views.size());
+        for (auto &[viewId, view]: veta.views) {
+            if (view) {
+                views.emplace_back(viewId, &view);
+            }
+        }
+        ParallelFor(0, views.size(), [&](std::size_t i) {
+            View::Ptr &view = *views[i].second;
+            if (view.use_count() > 1) {
+                view = std::make_shared<View>(*view);
+            }
+            view->viewId = views[i].first;
+            view->poseId = ToNewId(poseIds, view->poseId);
+            view->intrinsicId = ToNewId(intrinsicIds, view->intrinsicId);
+        }, 1024);
+
+        // observations, the new view ids keep the order, so that each node is inserted at the end
+        std::vector<Landmark *> landmarks;
+        landmarks.reserve(veta.structure.size());
+        for (auto &[lmId, lm]: veta.structure) {
+            landmarks.push_back(&lm);
+        }
+        ParallelFor(0, landmarks.size(), [&](std::size_t i) {
+            Observations &obs = landmarks[i]->obs;
+            Observations renumbered(obs.get_allocator());
+            while (!obs.empty()) {
+                auto node = obs.extract(obs.begin());
+                node.key() = ToNewId(viewIds, node.key());
+                if (node.key() != UndefinedIndexT) {
+                    renumbered.insert(renumbered.end(), std::move(node));
+                }
+            }
+            obs = std::move(renumbered);
+        }, 1024);
+
+        IdMap idMap;
+        idMap.views = ToTable(viewIds);
+        idMap.poses = ToTable(poseIds);
+        idMap.intrinsics = ToTable(intrinsicIds);
+        idMap.landmarks = ToTable(landmarkIds);
+        return idMap;
+    }
+}
@@ -0,0 +1,323 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/decimation.h"
+#include "view_slots.h"
+#include <algorithm>
+
+namespace ns_veta {
+
+    namespace {
+        // cells per axis of the voxel grid, so that the three coordinates pack into a 64-bit key
+        constexpr int KeyBits = 21;
+        constexpr uint64_t MaxCell = (uint64_t(1) << KeyBits) - 1;
+
+        // sort each chunk of the range in parallel, then merge the chunks pairwise
+        template<typename T, typename Compare>
+        void ParallelSort(std::vector<T> &values, Compare cmp) {
+            std::vector<std::pair<std::size_t, std::size_t>> ranges(HardwareThreads());
+            const std::size_t workers = ParallelForRange(0, values.size(), [&](std::size_t lo, std::size_t hi,
+                                                                                std::size_t w) {
+                std::sort(values.begin() + static_cast<std::ptrdiff_t>(lo),
+                          values.begin() + static_cast<std::ptrdiff_t>(hi), cmp);
+                ranges[w] = {lo, hi};
+            }, 1 << 16, ranges.size());
+            for (std::size_t width = 1; width < workers; width *= 2) {
+                const std::size_t pairs = (workers + 2 * width - 1) / (2 * width);
+                ParallelFor(0, pairs, [&](std::size_t p) {
+                    const std::size_t first = 2 * p * width, second = std::min(first + width, workers);
+                    if (second == workers) {
+                        return;
+                    }
+                    const std::size_t last = std::min(first + 2 * width, workers) - 1;
+                    auto begin = values.begin();
+                    std::inplace_merge(begin + static_cast<std::ptrdiff_t>(ranges[first].first),
+                                       begin + static_cast<std::ptrdiff_t>(ranges[second].first),
+                                       begin + static_cast<std::ptrdiff_t>(ranges[last].second), cmp);
+                }, 1);
+            }
+        }
+
+        // the voxel grid over the bounding box of the landmarks
+        struct VoxelGrid {
+        public:
+            Vec3d origin;
+            double size;
+
+            [[nodiscard]] uint64_t Key(const Vec3d &X, double &centerDist) const {
+                uint64_t key = 0;
+                Vec3d offset;
+                for (int d = 0; d < 3; ++d) {
+                    const double c = std::floor((X(d) - origin(d)) / size);
+                    const uint64_t cell = std::min(static_cast<uint64_t>(std::max(c, 0.0)), MaxCell);
+                    offset(d) = X(d) - (origin(d) + (static_cast<double>(cell) + 0.5) * size);
+                    key |= cell << (KeyBits * d);
+                }
+                centerDist = offset.squaredNorm();
+                return key;
+            }
+        };
+
+        // a landmark in its voxel, ordered by voxel then by preference
+        struct VoxelEntry {
+        public:
+            uint64_t key;
+            std::size_t observations;
+            double centerDist;
+            std::size_t index;
+
+            bool operator<(const VoxelEntry &other) const {
+                if (key != other.key) {
+                    return key < other.key;
+                }
+                if (observations != other.observations) {
+                    return observations > other.observations;
+                }
+                if (centerDist != other.centerDist) {
+                    return centerDist < other.centerDist;
+                }
+                return index < other.index;
+            }
+        };
+
+        std::size_t OccupiedVoxels(const std::vector<const Landmark *> &landmarks,
+                                   const std::vector<std::size_t> &indices, const VoxelGrid &grid) {
+            std::vector<uint64_t> keys(indices.size());
+            ParallelFor(0, indices.size(), [&](std::size_t i) {
+                double centerDist;
+                keys[i] = grid.Key(landmarks[indices[i]]->X, centerDist);
+            });
+            ParallelSort(keys, std::less<>());
+            return static_cast<std::size_t>(std::unique(keys.begin(), keys.end()) - keys.begin());
+        }
+
+        // secant search, in log space, of the voxel size giving 'target' occupied voxels. The voxels are counted
+        // on a strided sample of the landmarks, large enough for each voxel to hold several samples.
+        double SearchVoxelSize(const std::vector<const Landmark *> &landmarks, const std::vector<std::size_t> &finite,
+                               const Vec3d &origin, double extent, double minSize, std::size_t target,
+                               double tolerance) {
+            std::vector<std::size_t> sample;
+            const std::size_t sampleSize = std::min(finite.size(), std::max<std::size_t>(16 * target, 1 << 16));
+            sample.reserve(sampleSize);
+            for (std::size_t j = 0; j < sampleSize; ++j) {
+                sample.push_back(finite[j * finite.size() / sampleSize]);
+            }
+            const double logTarget = std::log(static_cast<double>(target));
+            // a uniformly filled box as first guess
+            double x0 = std::log(std::max(extent / std::cbrt(static_cast<double>(target)), minSize));
+            double y0 = std::log(static_cast<double>(OccupiedVoxels(landmarks, sample, {origin, std::exp(x0)})));
+            double best = x0, bestError = std::abs(y0 - logTarget);
+            // count ~ size^-slope, between a curve (1) and a volume (3)
+            double slope = 2.0;
+            for (int iter = 0; iter < 8 && bestError > std::log1p(tolerance); ++iter) {
+                const double x1 = std::max(x0 + (y0 - logTarget) / slope, std::log(minSize));
+                if (x1 == x0) {
+                    break;
+                }
+                const double y1 = std::log(static_cast<double>(OccupiedVoxels(landmarks, sample,
+                                                                               {origin, std::exp(x1)})));
+                if (std::abs(y1 - logTarget) < bestError) {
+                    best = x1;
+                    bestError = std::abs(y1 - logTarget);
+                }
+                if (y1 != y0) {
+                    slope = std::clamp((y0 - y1) / (x1 - x0), 1.0, 3.0);
+                }
+                x0 = x1;
+                y0 = y1;
+            }
+            return std::exp(best);
+        }
+    }
+
+    LandmarkMask DecimationMask(const Veta &veta, const DecimationOptions &options) {
+        std::vector<const Landmark *> landmarks;
+        landmarks.reserve(veta.structure.size());
+        for (const auto &[lmId, lm]: veta.structure) {
+            landmarks.push_back(&lm);
+        }
+        const std::size_t n = landmarks.size();
+        LandmarkMask mask(n, 0);
+
+        // bounding box of the finite landmarks
+        std::vector<uint8_t> isFinite(n, 0);
+        std::vector<std::pair<Vec3d, Vec3d>> boxes(HardwareThreads(), {
+                Vec3d::Constant(std::numeric_limits<double>::max()),
+                Vec3d::Constant(std::numeric_limits<double>::lowest())});
+        const std::size_t boxWorkers = ParallelForRange(0, n, [&](std::size_t lo, std::size_t hi, std::size_t w) {
+            auto &[boxMin, boxMax] = boxes[w];
+            for (std::size_t i = lo; i < hi; ++i) {
+                const Vec3d &X = landmarks[i]->X;
+                if (X.allFinite()) {
+                    isFinite[i] = 1;
+                    boxMin = boxMin.cwiseMin(X);
+                    boxMax = boxMax.cwiseMax(X);
+                }
+            }
+        }, 1024, boxes.size());
+        Vec3d boxMin = boxes[0].first, boxMax = boxes[0].second;
+        for (std::size_t w = 1; w < boxWorkers; ++w) {
+            boxMin = boxMin.cwiseMin(boxes[w].first);
+            boxMax = boxMax.cwiseMax(boxes[w].second);
+        }
+        std::vector<std::size_t> finite;
+        finite.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (isFinite[i]) {
+                finite.push_back(i);
+            }
+        }
+
+        // one landmark per voxel
+        const bool voxelize = options.voxelSize > 0.0 || finite.size() > options.targetLandmarks;
+        if (!voxelize || finite.empty()) {
+            for (const std::size_t i: finite) {
+                mask[i] = 1;
+            }
+        } else {
+            const double extent = std::max((boxMax - boxMin).maxCoeff(), std::numeric_limits<double>::min());
+            const double minSize = extent / static_cast<double>(MaxCell);
+            VoxelGrid grid{boxMin, std::max(options.voxelSize, minSize)};
+            if (options.voxelSize <= 0.0) {
+                grid.size = options.targetLandmarks == 0
+                            ? extent * 2.0
+                            : SearchVoxelSize(landmarks, finite, boxMin, extent, minSize, options.targetLandmarks,
+                                              options.targetTolerance);
+            }
+            std::vector<VoxelEntry> entries(finite.size());
+            ParallelFor(0, finite.size(), [&](std::size_t j) {
+                const std::size_t i = finite[j];
+                VoxelEntry &entry = entries[j];
+                entry.key = grid.Key(landmarks[i]->X, entry.centerDist);
+                entry.observations = landmarks[i]->obs.size();
+                entry.index = i;
+            });
+            ParallelSort(entries, std::less<>());
+            for (std::size_t j = 0; j < entries.size(); ++j) {
+                if (j == 0 || entries[j].key != entries[j - 1].key) {
+                    mask[entries[j].index] = 1;
+                }
+            }
+        }
+
+        if (options.minLandmarksPerView == 0) {
+            return mask;
+        }
+
+        // observed and kept landmarks of each view
+        const ViewSlots viewSlots = ViewSlots::Build(veta, false);
+        const HashMap<IndexT, uint32_t> &slotOfView = viewSlots.slotOfView;
+        const std::size_t views = viewSlots.slots.size();
+        std::vector<std::vector<std::size_t>> observed(HardwareThreads()), kept(observed.size());
+        const std::size_t countWorkers = ParallelForRange(0, n, [&](std::size_t lo, std::size_t hi, std::size_t w) {
+            observed[w].assign(views, 0);
+            kept[w].assign(views, 0);
+            for (std::size_t i = lo; i < hi; ++i) {
+                if (!isFinite[i]) {
+                    continue;
+                }
+                for (const auto &[viewId, obs]: landmarks[i]->obs) {
+                    auto iter = slotOfView.find(viewId);
+                    if (iter != slotOfView.cend()) {
+                        ++observed[w][iter->second];
+                        kept[w][iter->second] += mask[i];
+                    }
+                }
+            }
+        }, 1024, observed.size());
+        std::vector<std::size_t> missing(views, 0);
+        bool anyMissing = false;
+        for (std::size_t s = 0; s < views; ++s) {
+            std::size_t observedCount = 0, keptCount = 0;
+            for (std::size_t w = 0; w < countWorkers; ++w) {
+                observedCount += observed[w][s];
+                keptCount += kept[w][s];
+            }
+            const std::size_t required = std::min(options.minLandmarksPerView, observedCount);
+            missing[s] = required > keptCount ? required - keptCount : 0;
+            anyMissing |= missing[s] != 0;
+        }
+        if (!anyMissing) {
+            return mask;
+        }
+
+        // the dropped landmarks observed by a view missing some, best-observed first
+        std::vector<std::vector<std::size_t>> candidates(HardwareThreads());
+        const std::size_t candidateWorkers = ParallelForRange(0, n, [&](std::size_t lo, std::size_t hi,
+                                                                        std::size_t w) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                if (!isFinite[i] || mask[i]) {
+                    continue;
+                }
+                for (const auto &[viewId, obs]: landmarks[i]->obs) {
+                    auto iter = slotOfView.find(viewId);
+                    if (iter != slotOfView.cend() && missing[iter->second] != 0) {
+                        candidates[w].push_back(i);
+                        break;
+                    }
+                }
+            }
+        }, 1024, candidates.size());
+        // bucketed by number of observations, the indices stay sorted in each bucket
+        std::size_t maxObs = 0;
+        for (std::size_t w = 0; w < candidateWorkers; ++w) {
+            for (const std::size_t i: candidates[w]) {
+                maxObs = std::max(maxObs, landmarks[i]->obs.size());
+            }
+        }
+        std::vector<std::size_t> bucketStart(maxObs + 2, 0);
+        for (std::size_t w = 0; w < candidateWorkers; ++w) {
+            for (const std::size_t i: candidates[w]) {
+                ++bucketStart[maxObs - landmarks[i]->obs.size() + 1];
+            }
+        }
+        for (std::size_t b = 1; b < bucketStart.size(); ++b) {
+            bucketStart[b] += bucketStart[b - 1];
+        }
+        std::vector<std::size_t> order(bucketStart.back());
+        for (std::size_t w = 0; w < candidateWorkers; ++w) {
+            for (const std::size_t i: candidates[w]) {
+                order[bucketStart[maxObs - landmarks[i]->obs.size()]++] = i;
+            }
+        }
+
+        // greedy completion: a candidate is kept if one of its views still misses some
+        for (const std::size_t i: order) {
+            bool useful = false;
+            for (const auto &[viewId, obs]: landmarks[i]->obs) {
+                auto iter = slotOfView.find(viewId);
+                if (iter != slotOfView.cend() && missing[iter->second] != 0) {
+                    useful = true;
+                    break;
+                }
+            }
+            if (!useful) {
+                continue;
+            }
+            mask[i] = 1;
+            for (const auto &[viewId, obs]: landmarks[i]->obs) {
+                auto iter = slotOfView.find(viewId);
+                if (iter != slotOfView.cend() && missing[iter->second] != 0) {
+                    --missing[iter->second];
+                }
+            }
+        }
+        return mask;
+    }
+
+    Veta Decimate(const Veta &veta, const DecimationOptions &options) {
+        const LandmarkMask mask = DecimationMask(veta, options);
+        Veta result;
+        result.views = veta.views;
+        result.poses = veta.poses;
+        result.intrinsics = veta.intrinsics;
+        std::size_t i = 0;
+        for (const auto &[lmId, lm]: veta.structure) {
+            if (mask[i++]) {
+                result.structure.emplace_hint(result.structure.end(), lmId, lm);
+            }
+        }
+        return result;
+    }
+}
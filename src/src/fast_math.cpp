@@ -0,0 +1,21 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/fast_math.h"
+#include "veta/simd.h"
+
+namespace ns_veta {
+
+    void FastMath::SinCos(const Eigen::ArrayXd &x, Eigen::ArrayXd &sin, Eigen::ArrayXd &cos) {
+        sin.resize(x.size());
+        cos.resize(x.size());
+        SimdDispatch::Kernels().sinCos(x.data(), sin.data(), cos.data(), x.size());
+    }
+
+    Eigen::ArrayXd FastMath::Atan2(const Eigen::ArrayXd &y, const Eigen::ArrayXd &x) {
+        Eigen::ArrayXd a(std::min(y.size(), x.size()));
+        SimdDispatch::Kernels().atan2(y.data(), x.data(), a.data(), a.size());
+        return a;
+    }
+}
@@ -0,0 +1,139 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/group_intrinsics.h"
+#include "veta/utils.hpp"
+#include <numeric>
+#include <unordered_map>
+
+namespace ns_veta {
+
+    namespace {
+        bool SameCamera(const IntrinsicBase &a, const IntrinsicBase &b) {
+            return a.GetType() == b.GetType() && a.Width() == b.Width() && a.Height() == b.Height() &&
+                   a.ParamsSize() == b.ParamsSize();
+        }
+
+        bool ParamsMatch(const IntrinsicBase &a, const IntrinsicBase &b, double tolerance) {
+            const double *pa = a.ParamsAddress(), *pb = b.ParamsAddress();
+            for (std::size_t i = 0; i < a.ParamsSize(); ++i) {
+                const double scale = std::max({1.0, std::abs(pa[i]), std::abs(pb[i])});
+                if (std::abs(pa[i] - pb[i]) > tolerance * scale) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // the first parameter, or zero if none
+        double FirstParam(const IntrinsicBase &intrinsic) {
+            return intrinsic.ParamsSize() != 0 ? intrinsic.ParamsAddress()[0] : 0.0;
+        }
+    }
+
+    HashMap<IndexT, IndexT> GroupIntrinsics(Veta &veta, double tolerance) {
+        // ids are visited in increasing order, so that the first intrinsic of a group has the smallest id
+        std::vector<std::pair<IndexT, const IntrinsicBase *>> intrinsics;
+        intrinsics.reserve(veta.intrinsics.size());
+        for (const auto &[intrinsicId, intrinsic]: veta.intrinsics) {
+            if (intrinsic) {
+                intrinsics.emplace_back(intrinsicId, intrinsic.get());
+            }
+        }
+
+        std::unordered_map<std::size_t, std::vector<std::size_t>> buckets;
+        for (std::size_t i = 0; i < intrinsics.size(); ++i) {
+            const IntrinsicBase &intrinsic = *intrinsics[i].second;
+            std::size_t hash = 0;
+            if (tolerance == 0.0) {
+                hash = intrinsic.HashValue();
+            } else {
+                HashCombine(hash, static_cast<int>(intrinsic.GetType()));
+                HashCombine(hash, intrinsic.Width());
+                HashCombine(hash, intrinsic.Height());
+                HashCombine(hash, intrinsic.ParamsSize());
+            }
+            buckets[hash].push_back(i);
+        }
+
+        // the index of the kept intrinsic of each one
+        std::vector<std::size_t> kept(intrinsics.size());
+        std::iota(kept.begin(), kept.end(), 0);
+        for (auto &[hash, bucket]: buckets) {
+            if (tolerance == 0.0) {
+                for (std::size_t j = 0; j < bucket.size(); ++j) {
+                    const IntrinsicBase &cur = *intrinsics[bucket[j]].second;
+                    for (std::size_t k = 0; k < j; ++k) {
+                        const std::size_t other = bucket[k];
+                        if (kept[other] == other && SameCamera(cur, *intrinsics[other].second) &&
+                            ParamsMatch(cur, *intrinsics[other].second, 0.0)) {
+                            kept[bucket[j]] = other;
+                            break;
+                        }
+                    }
+                }
+                continue;
+            }
+            // sweep over the sorted first parameters, the candidates match the first parameter of the seed
+            std::stable_sort(bucket.begin(), bucket.end(), [&](std::size_t a, std::size_t b) {
+                return FirstParam(*intrinsics[a].second) < FirstParam(*intrinsics[b].second);
+            });
+            std::vector<uint8_t> grouped(bucket.size(), 0);
+            for (std::size_t j = 0; j < bucket.size(); ++j) {
+                if (grouped[j]) {
+                    continue;
+                }
+                const IntrinsicBase &seed = *intrinsics[bucket[j]].second;
+                const double first = FirstParam(seed);
+                std::vector<std::size_t> group{bucket[j]};
+                for (std::size_t k = j + 1; k < bucket.size(); ++k) {
+                    const double cur = FirstParam(*intrinsics[bucket[k]].second);
+                    if (cur - first > tolerance * std::max({1.0, std::abs(first), std::abs(cur)})) {
+                        break;
+                    }
+                    if (!grouped[k] && SameCamera(seed, *intrinsics[bucket[k]].second) &&
+                        ParamsMatch(seed, *intrinsics[bucket[k]].second, tolerance)) {
+                        grouped[k] = 1;
+                        group.push_back(bucket[k]);
+                    }
+                }
+                const std::size_t smallest = *std::min_element(group.cbegin(), group.cend());
+                for (const std::size_t i: group) {
+                    kept[i] = smallest;
+                }
+            }
+        }
+
+        HashMap<IndexT, IndexT> collapsed;
+        for (std::size_t i = 0; i < intrinsics.size(); ++i) {
+            if (kept[i] != i) {
+                collapsed.emplace_hint(collapsed.end(), intrinsics[i].first, intrinsics[kept[i]].first);
+            }
+        }
+        if (collapsed.empty()) {
+            return collapsed;
+        }
+
+        // rewrite the views in bulk
+        std::vector<View::Ptr *> views;
+        views.reserve(veta.views.size());
+        for (auto &[viewId, view]: veta.views) {
+            if (view && collapsed.count(view->intrinsicId) != 0) {
+                views.push_back(&view);
+            }
+        }
+        ParallelFor(0, views.size(), [&](std::size_t i) {
+            View::Ptr &view = *views[i];
+            if (view.use_count() > 1) {
+                view = std::make_shared<View>(*view);
+            }
+            view->intrinsicId = collapsed.at(view->intrinsicId);
+        }, 1024);
+
+        for (const auto &[intrinsicId, keptId]: collapsed) {
+            veta.intrinsics.erase(intrinsicId);
+        }
+        return collapsed;
+    }
+}
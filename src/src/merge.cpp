@@ -0,0 +1,245 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/merge.h"
+#include "veta/utils.hpp"
+#include <numeric>
+#include <unordered_map>
+
+namespace ns_veta {
+
+    namespace {
+        // an observed feature of a merged view, the views of different scenes share an id only once merged
+        struct ObsKey {
+            IndexT viewId, featId;
+
+            bool operator==(const ObsKey &other) const {
+                return viewId == other.viewId && featId == other.featId;
+            }
+        };
+
+        struct ObsKeyHash {
+            std::size_t operator()(const ObsKey &key) const {
+                std::size_t seed = 0;
+                HashCombine(seed, key.viewId);
+                HashCombine(seed, key.featId);
+                return seed;
+            }
+        };
+
+        // union-find root, with path halving
+        std::size_t FindRoot(std::vector<std::size_t> &parent, std::size_t i) {
+            while (parent[i] != i) {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        }
+
+        bool SameIntrinsic(const IntrinsicBase &a, const IntrinsicBase &b) {
+            return a.GetType() == b.GetType() && a.Width() == b.Width() && a.Height() == b.Height() &&
+                   a.GetParams() == b.GetParams();
+        }
+
+        IndexT MapId(const HashMap<IndexT, IndexT> &map, IndexT id) {
+            auto iter = map.find(id);
+            return iter == map.cend() ? UndefinedIndexT : iter->second;
+        }
+    }
+
+    Veta MergeScenes(const std::vector<const Veta *> &scenes, const MergeOptions &options,
+                     std::vector<IdMap> *idMaps) {
+        std::vector<IdMap> maps(scenes.size());
+        Veta result;
+
+        // intrinsics, the identical ones are found by their hash values
+        std::unordered_multimap<std::size_t, IndexT> intrinsicsByHash;
+        IndexT nextIntrinsicId = 0;
+        for (std::size_t k = 0; k < scenes.size(); ++k) {
+            for (const auto &[intrinsicId, intrinsic]: scenes[k]->intrinsics) {
+                IndexT newId = UndefinedIndexT;
+                const std::size_t hash = intrinsic ? intrinsic->HashValue() : 0;
+                if (options.dedupIntrinsics && intrinsic) {
+                    auto range = intrinsicsByHash.equal_range(hash);
+                    for (auto iter = range.first; iter != range.second; ++iter) {
+                        if (SameIntrinsic(*result.intrinsics.at(iter->second), *intrinsic)) {
+                            newId = iter->second;
+                            break;
+                        }
+                    }
+                }
+                if (newId == UndefinedIndexT) {
+                    newId = nextIntrinsicId++;
+                    result.intrinsics.emplace_hint(result.intrinsics.end(), newId, intrinsic);
+                    if (intrinsic) {
+                        intrinsicsByHash.emplace(hash, newId);
+                    }
+                }
+                maps[k].intrinsics.emplace_hint(maps[k].intrinsics.end(), intrinsicId, newId);
+            }
+        }
+
+        // views and poses, the views of the previous scenes are found by (timestamp, new intrinsic id). The keys of
+        // the landmark deduplication are the new view ids, so that it only spans the scenes through merged views
+        const bool mergeViews = options.mergeViewsByTimestamp;
+        std::multimap<TimeT, IndexT> viewsByTime;
+        IndexT nextViewId = 0, nextPoseId = 0;
+        for (std::size_t k = 0; k < scenes.size(); ++k) {
+            IdMap &map = maps[k];
+            std::vector<View::Ptr> newViews;
+            // the poses of the merged views are the ones of the views they are merged into
+            HashMap<IndexT, IndexT> poseAlias;
+            for (const auto &[viewId, view]: scenes[k]->views) {
+                if (!view) {
+                    continue;
+                }
+                const IndexT intrinsicId = MapId(map.intrinsics, view->intrinsicId);
+                IndexT newId = UndefinedIndexT;
+                if (mergeViews && view->timestamp != UndefinedTimeT) {
+                    auto range = viewsByTime.equal_range(view->timestamp);
+                    for (auto iter = range.first; iter != range.second; ++iter) {
+                        const View &other = *result.views.at(iter->second);
+                        if (other.intrinsicId == intrinsicId) {
+                            newId = other.viewId;
+                            if (other.poseId != UndefinedIndexT) {
+                                poseAlias.insert({view->poseId, other.poseId});
+                            }
+                            break;
+                        }
+                    }
+                }
+                if (newId == UndefinedIndexT) {
+                    newId = nextViewId++;
+                    auto newView = std::make_shared<View>(*view);
+                    newView->viewId = newId;
+                    newView->intrinsicId = intrinsicId;
+                    newViews.push_back(newView);
+                }
+                map.views.emplace_hint(map.views.end(), viewId, newId);
+            }
+
+            for (const auto &[poseId, pose]: scenes[k]->poses) {
+                auto aliasIter = poseAlias.find(poseId);
+                if (aliasIter != poseAlias.cend()) {
+                    map.poses.emplace_hint(map.poses.end(), poseId, aliasIter->second);
+                } else {
+                    map.poses.emplace_hint(map.poses.end(), poseId, nextPoseId);
+                    result.poses.emplace_hint(result.poses.end(), nextPoseId++, pose);
+                }
+            }
+
+            for (const auto &view: newViews) {
+                view->poseId = MapId(map.poses, view->poseId);
+                result.views.emplace_hint(result.views.end(), view->viewId, view);
+            }
+            // only the views of the previous scenes are merged into
+            for (const auto &view: newViews) {
+                if (view->timestamp != UndefinedTimeT) {
+                    viewsByTime.insert({view->timestamp, view->viewId});
+                }
+            }
+        }
+
+        // landmarks, in a flat list ordered by scene then by id
+        struct Item {
+            std::size_t scene;
+            IndexT lmId;
+            const Landmark *lm;
+        };
+        std::vector<Item> items;
+        std::size_t total = 0;
+        for (const Veta *scene: scenes) {
+            total += scene->structure.size();
+        }
+        items.reserve(total);
+        for (std::size_t k = 0; k < scenes.size(); ++k) {
+            for (const auto &[lmId, lm]: scenes[k]->structure) {
+                items.push_back({k, lmId, &lm});
+            }
+        }
+
+        // remap the observations by blocks of landmarks, the observed features are dispatched to shards
+        const std::size_t blocks = std::min<std::size_t>(HardwareThreads(), std::max<std::size_t>(1, total / 4096));
+        const std::size_t shards = blocks;
+        using Bucket = std::vector<std::pair<ObsKey, std::size_t>>;
+        std::vector<std::vector<Bucket>> buckets(blocks, std::vector<Bucket>(shards));
+        std::vector<Landmark> merged(items.size());
+        ParallelFor(0, blocks, [&](std::size_t b) {
+            const ObsKeyHash hasher;
+            for (std::size_t i = total * b / blocks; i < total * (b + 1) / blocks; ++i) {
+                const Landmark &lm = *items[i].lm;
+                const HashMap<IndexT, IndexT> &viewMap = maps[items[i].scene].views;
+                Landmark &newLm = merged[i];
+                newLm.X = lm.X;
+                newLm.color = lm.color;
+                for (const auto &[viewId, obs]: lm.obs) {
+                    // the observations of missing views are dropped
+                    auto iter = viewMap.find(viewId);
+                    if (iter == viewMap.cend()) {
+                        continue;
+                    }
+                    newLm.obs.insert({iter->second, obs});
+                    if (options.dedupLandmarks && obs.featId != UndefinedObsFeatIdT) {
+                        const ObsKey key{iter->second, obs.FeatId()};
+                        buckets[b][hasher(key) % shards].emplace_back(key, i);
+                    }
+                }
+            }
+        }, 1);
+
+        // each shard finds the landmarks sharing an observed feature with a previous one
+        std::vector<std::vector<std::pair<std::size_t, std::size_t>>> links(shards);
+        ParallelFor(0, shards, [&](std::size_t s) {
+            std::unordered_map<ObsKey, std::size_t, ObsKeyHash> first;
+            for (std::size_t b = 0; b < blocks; ++b) {
+                for (const auto &[key, i]: buckets[b][s]) {
+                    auto [iter, inserted] = first.insert({key, i});
+                    if (!inserted && iter->second != i) {
+                        links[s].emplace_back(iter->second, i);
+                    }
+                }
+            }
+        }, 1);
+        buckets.clear();
+
+        // groups of duplicated landmarks, rooted at their first landmark
+        std::vector<std::size_t> parent(total);
+        std::iota(parent.begin(), parent.end(), 0);
+        for (const auto &shardLinks: links) {
+            for (const auto &[i, j]: shardLinks) {
+                const std::size_t ri = FindRoot(parent, i), rj = FindRoot(parent, j);
+                if (ri != rj) {
+                    parent[std::max(ri, rj)] = std::min(ri, rj);
+                }
+            }
+        }
+
+        std::vector<IndexT> newLmIds(total, UndefinedIndexT);
+        IndexT nextLmId = 0;
+        for (std::size_t i = 0; i < total; ++i) {
+            const std::size_t root = FindRoot(parent, i);
+            if (root != i) {
+                // the observations of the first landmark are kept for the views observed twice
+                merged[root].obs.insert(merged[i].obs.cbegin(), merged[i].obs.cend());
+                newLmIds[i] = newLmIds[root];
+            } else {
+                newLmIds[i] = nextLmId++;
+            }
+        }
+        for (std::size_t i = 0; i < total; ++i) {
+            if (parent[i] == i) {
+                result.structure.emplace_hint(result.structure.end(), newLmIds[i], std::move(merged[i]));
+            }
+        }
+
+        if (idMaps != nullptr) {
+            for (std::size_t i = 0; i < total; ++i) {
+                auto &lmMap = maps[items[i].scene].landmarks;
+                lmMap.emplace_hint(lmMap.end(), items[i].lmId, newLmIds[i]);
+            }
+            *idMaps = std::move(maps);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,179 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/pose_batch.h"
+#include "veta/simd.h"
+#include "veta/utils.hpp"
+
+namespace ns_veta {
+
+    PoseBatch::PoseBatch(const Poses &poses, const std::vector<IndexT> &ids) {
+        if (ids.empty()) {
+            Reserve(poses.size());
+            for (const auto &[poseId, pose]: poses) {
+                PushBack(pose, poseId);
+            }
+        } else {
+            Reserve(ids.size());
+            for (const IndexT poseId: ids) {
+                auto iter = poses.find(poseId);
+                if (iter != poses.cend()) {
+                    PushBack(iter->second, poseId);
+                }
+            }
+        }
+    }
+
+    PoseBatch::Ptr PoseBatch::Create(const Poses &poses, const std::vector<IndexT> &ids) {
+        return std::make_shared<PoseBatch>(poses, ids);
+    }
+
+    void PoseBatch::Reserve(std::size_t size) {
+        poseIds.reserve(size);
+        rotations.reserve(9 * size);
+        translations.reserve(3 * size);
+    }
+
+    void PoseBatch::PushBack(const Posed &pose, IndexT poseId) {
+        poseIds.push_back(poseId);
+        const Mat3d R = pose.Rotation().matrix();
+        rotations.insert(rotations.end(), R.data(), R.data() + 9);
+        const Vec3d &t = pose.Translation();
+        translations.insert(translations.end(), t.data(), t.data() + 3);
+    }
+
+    std::size_t PoseBatch::Size() const {
+        return poseIds.size();
+    }
+
+    const std::vector<IndexT> &PoseBatch::PoseIds() const {
+        return poseIds;
+    }
+
+    const double *PoseBatch::RotationsData() const {
+        return rotations.data();
+    }
+
+    const double *PoseBatch::TranslationsData() const {
+        return translations.data();
+    }
+
+    Eigen::Map<const Mat3d> PoseBatch::Rotation(std::size_t i) const {
+        return Eigen::Map<const Mat3d>(rotations.data() + 9 * i);
+    }
+
+    Eigen::Map<Mat3d> PoseBatch::Rotation(std::size_t i) {
+        return Eigen::Map<Mat3d>(rotations.data() + 9 * i);
+    }
+
+    Eigen::Map<const Vec3d> PoseBatch::Translation(std::size_t i) const {
+        return Eigen::Map<const Vec3d>(translations.data() + 3 * i);
+    }
+
+    Eigen::Map<Vec3d> PoseBatch::Translation(std::size_t i) {
+        return Eigen::Map<Vec3d>(translations.data() + 3 * i);
+    }
+
+    Posed PoseBatch::At(std::size_t i) const {
+        return Posed(Sophus::SO3d(Quaterniond(Mat3d(Rotation(i))).normalized()), Translation(i));
+    }
+
+    PoseBatch PoseBatch::InverseAll() const {
+        PoseBatch result;
+        result.poseIds = poseIds;
+        result.rotations.resize(rotations.size());
+        result.translations.resize(translations.size());
+        ParallelForRange(0, Size(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                // (R, t)^-1 = (R^T, -R^T * t)
+                const Mat3d Rt = Rotation(i).transpose();
+                result.Rotation(i) = Rt;
+                result.Translation(i) = -(Rt * Translation(i));
+            }
+        }, 4096);
+        return result;
+    }
+
+    PoseBatch PoseBatch::ComposeAll(const PoseBatch &lhs, const PoseBatch &rhs) {
+        const std::size_t size = std::max(lhs.Size(), rhs.Size());
+        if ((lhs.Size() != size && lhs.Size() != 1) || (rhs.Size() != size && rhs.Size() != 1)) {
+            throw std::invalid_argument("the sizes of the pose batches to compose do not match: " +
+                                        std::to_string(lhs.Size()) + " and " + std::to_string(rhs.Size()));
+        }
+        // the stride of a broadcast batch is zero
+        const std::size_t ls = lhs.Size() == size ? 1 : 0, rs = rhs.Size() == size ? 1 : 0;
+
+        PoseBatch result;
+        result.poseIds = lhs.Size() == size ? lhs.poseIds : rhs.poseIds;
+        result.rotations.resize(9 * size);
+        result.translations.resize(3 * size);
+        ParallelForRange(0, size, [&](std::size_t lo, std::size_t hi, std::size_t) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                // (Ra, ta) * (Rb, tb) = (Ra * Rb, Ra * tb + ta)
+                const auto Ra = lhs.Rotation(i * ls);
+                result.Rotation(i).noalias() = Ra * rhs.Rotation(i * rs);
+                result.Translation(i) = Ra * rhs.Translation(i * rs) + lhs.Translation(i * ls);
+            }
+        }, 4096);
+        return result;
+    }
+
+    std::vector<Mat3Xd> PoseBatch::TransformPoints(const Mat3Xd &X) const {
+        std::vector<Mat3Xd> result(Size());
+        const std::size_t count = X.cols();
+        // enough points per worker to pay for a thread
+        const std::size_t minChunk = std::max<std::size_t>(1, (1 << 16) / std::max<std::size_t>(count, 1));
+        const SimdKernels &kernels = SimdDispatch::Kernels();
+        ParallelForRange(0, Size(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+            for (std::size_t i = lo; i < hi; ++i) {
+                result[i].resize(3, X.cols());
+                kernels.transformPoints(rotations.data() + 9 * i, translations.data() + 3 * i,
+                                        X.data(), result[i].data(), count);
+            }
+        }, minChunk);
+        return result;
+    }
+
+    void PoseBatch::WriteBack(Poses &poses) const {
+        for (std::size_t i = 0; i < Size(); ++i) {
+            if (poseIds[i] == UndefinedIndexT) {
+                continue;
+            }
+            auto iter = poses.find(poseIds[i]);
+            if (iter == poses.end()) {
+                poses.insert({poseIds[i], At(i)});
+            } else {
+                iter->second = At(i);
+            }
+        }
+    }
+
+    std::vector<Mat3Xd> TransformPoints(const Veta &veta, const std::vector<IndexT> &viewIds, const Mat3Xd &X) {
+        // pack the poses of the views having one
+        PoseBatch batch;
+        batch.Reserve(viewIds.size());
+        std::vector<std::size_t> slots(viewIds.size(), std::numeric_limits<std::size_t>::max());
+        for (std::size_t i = 0; i < viewIds.size(); ++i) {
+            auto viewIter = veta.views.find(viewIds[i]);
+            if (viewIter == veta.views.cend() || !viewIter->second) {
+                continue;
+            }
+            auto poseIter = veta.poses.find(viewIter->second->poseId);
+            if (poseIter == veta.poses.cend()) {
+                continue;
+            }
+            slots[i] = batch.Size();
+            batch.PushBack(poseIter->second, poseIter->first);
+        }
+
+        std::vector<Mat3Xd> transformed = batch.TransformPoints(X);
+        std::vector<Mat3Xd> result(viewIds.size());
+        for (std::size_t i = 0; i < viewIds.size(); ++i) {
+            if (slots[i] != std::numeric_limits<std::size_t>::max()) {
+                result[i] = std::move(transformed[slots[i]]);
+            }
+        }
+        return result;
+    }
+}
@@ -0,0 +1,315 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/resection.h"
+#include <eigen3/Eigen/Eigenvalues>
+#include <eigen3/Eigen/SVD>
+#include <complex>
+#include <random>
+
+namespace ns_veta {
+
+    namespace {
+        // the rigid transform 'Q = R * P + t' of three point pairs (Kabsch)
+        void AlignPoints(const Mat3d &P, const Mat3d &Q, Mat3d &R, Vec3d &t) {
+            const Vec3d pc = P.rowwise().mean(), qc = Q.rowwise().mean();
+            const Mat3d H = (P.colwise() - pc) * (Q.colwise() - qc).transpose();
+            const Eigen::JacobiSVD<Mat3d> svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+            Mat3d D = Mat3d::Identity();
+            D(2, 2) = (svd.matrixV() * svd.matrixU().transpose()).determinant() < 0.0 ? -1.0 : 1.0;
+            R = svd.matrixV() * D * svd.matrixU().transpose();
+            t = qc - R * pc;
+        }
+
+        // the real roots of 'c4 * v^4 + c3 * v^3 + c2 * v^2 + c1 * v + c0'
+        std::vector<double> SolveQuartic(double c4, double c3, double c2, double c1, double c0) {
+            std::vector<double> roots;
+            if (std::abs(c4) < 1E-14) {
+                return roots;
+            }
+            Mat4d companion = Mat4d::Zero();
+            companion.bottomLeftCorner<3, 3>().setIdentity();
+            companion(0, 3) = -c0 / c4;
+            companion(1, 3) = -c1 / c4;
+            companion(2, 3) = -c2 / c4;
+            companion(3, 3) = -c3 / c4;
+            const Eigen::EigenSolver<Mat4d> solver(companion, false);
+            for (Eigen::Index i = 0; i < 4; ++i) {
+                const std::complex<double> root = solver.eigenvalues()(i);
+                if (std::abs(root.imag()) > 1E-6 * (1.0 + std::abs(root.real()))) {
+                    continue;
+                }
+                // polished by Newton steps
+                double v = root.real();
+                for (int iter = 0; iter < 2; ++iter) {
+                    const double f = (((c4 * v + c3) * v + c2) * v + c1) * v + c0;
+                    const double df = ((4.0 * c4 * v + 3.0 * c3) * v + 2.0 * c2) * v + c1;
+                    if (df != 0.0) {
+                        v -= f / df;
+                    }
+                }
+                roots.push_back(v);
+            }
+            return roots;
+        }
+
+        /**
+        * @brief Grunert's P3P (as reviewed by Haralick et al.): the depths 's1, s2 = u * s1, s3 = v * s1' of three
+        * points along their unit bearings, from the distances between the points, then the pose aligning them
+        */
+        std::vector<std::pair<Mat3d, Vec3d>> SolveP3P(const Mat3d &P, const Mat3d &bearings) {
+            std::vector<std::pair<Mat3d, Vec3d>> poses;
+            const double a2 = (P.col(1) - P.col(2)).squaredNorm();
+            const double b2 = (P.col(0) - P.col(2)).squaredNorm();
+            const double c2 = (P.col(0) - P.col(1)).squaredNorm();
+            if (b2 < 1E-12) {
+                return poses;
+            }
+            const double cosA = bearings.col(1).dot(bearings.col(2));
+            const double cosB = bearings.col(0).dot(bearings.col(2));
+            const double cosG = bearings.col(0).dot(bearings.col(1));
+
+            const double amc = (a2 - c2) / b2, apc = (a2 + c2) / b2, bmc = (b2 - c2) / b2, bma = (b2 - a2) / b2;
+            const double k4 = (amc - 1.0) * (amc - 1.0) - 4.0 * c2 / b2 * cosA * cosA;
+            const double k3 = 4.0 * (amc * (1.0 - amc) * cosB - (1.0 - apc) * cosA * cosG +
+                                     2.0 * c2 / b2 * cosA * cosA * cosB);
+            const double k2 = 2.0 * (amc * amc - 1.0 + 2.0 * amc * amc * cosB * cosB + 2.0 * bmc * cosA * cosA -
+                                     4.0 * apc * cosA * cosB * cosG + 2.0 * bma * cosG * cosG);
+            const double k1 = 4.0 * (-amc * (1.0 + amc) * cosB + 2.0 * a2 / b2 * cosG * cosG * cosB -
+                                     (1.0 - apc) * cosA * cosG);
+            const double k0 = (1.0 + amc) * (1.0 + amc) - 4.0 * a2 / b2 * cosG * cosG;
+
+            for (const double v: SolveQuartic(k4, k3, k2, k1, k0)) {
+                const double den = 2.0 * (cosG - v * cosA);
+                if (std::abs(den) < 1E-12 || v <= 0.0) {
+                    continue;
+                }
+                const double u = ((amc - 1.0) * v * v - 2.0 * amc * cosB * v + 1.0 + amc) / den;
+                const double s2 = 1.0 + v * v - 2.0 * v * cosB;
+                if (u <= 0.0 || s2 <= 0.0) {
+                    continue;
+                }
+                const double s1 = std::sqrt(b2 / s2);
+                Mat3d Q;
+                Q.col(0) = s1 * bearings.col(0);
+                Q.col(1) = u * s1 * bearings.col(1);
+                Q.col(2) = v * s1 * bearings.col(2);
+                Mat3d R;
+                Vec3d t;
+                AlignPoints(P, Q, R, t);
+                if (R.allFinite() && t.allFinite()) {
+                    poses.emplace_back(R, t);
+                }
+            }
+            return poses;
+        }
+
+        // the squared reprojection errors, infinite for the points behind the camera
+        Eigen::ArrayXd SquaredErrors(const IntrinsicBase &intrinsic, const Mat3d &R, const Vec3d &t,
+                                     const Mat3Xd &X, const Mat2Xd &x, const Mat3Xd &bearings) {
+            const Mat3Xd Xc = (R * X).colwise() + t;
+            Eigen::ArrayXd errors = intrinsic.Residuals(Xc, x).colwise().squaredNorm().transpose().array();
+            const Eigen::ArrayXd front = (Xc.array() * bearings.array()).colwise().sum().transpose();
+            errors = (front > 0.0).select(errors, std::numeric_limits<double>::infinity());
+            return errors;
+        }
+
+        // Gauss-Newton on the bearing errors, the rotation is updated on the left
+        void RefinePose(const Mat3Xd &X, const Mat3Xd &bearings, const std::vector<Eigen::Index> &inliers,
+                        Mat3d &R, Vec3d &t, int iterations) {
+            auto Cost = [&](const Mat3d &R_, const Vec3d &t_) {
+                double cost = 0.0;
+                for (const Eigen::Index i: inliers) {
+                    cost += ((R_ * X.col(i) + t_).normalized() - bearings.col(i)).squaredNorm();
+                }
+                return cost;
+            };
+            double cost = Cost(R, t);
+            for (int iter = 0; iter < iterations; ++iter) {
+                Eigen::Matrix<double, 6, 6> H = Eigen::Matrix<double, 6, 6>::Zero();
+                Eigen::Matrix<double, 6, 1> g = Eigen::Matrix<double, 6, 1>::Zero();
+                for (const Eigen::Index i: inliers) {
+                    const Vec3d RX = R * X.col(i);
+                    const Vec3d y = RX + t;
+                    const double norm = y.norm();
+                    const Vec3d u = y / norm;
+                    const Mat3d du = (Mat3d::Identity() - u * u.transpose()) / norm;
+                    Eigen::Matrix<double, 3, 6> J;
+                    J.leftCols<3>() << 0.0, RX(2), -RX(1), -RX(2), 0.0, RX(0), RX(1), -RX(0), 0.0;
+                    J.rightCols<3>().setIdentity();
+                    J = du * J;
+                    H.noalias() += J.transpose() * J;
+                    g.noalias() += J.transpose() * (u - bearings.col(i));
+                }
+                const Eigen::Matrix<double, 6, 1> delta = -H.ldlt().solve(g);
+                if (!delta.allFinite()) {
+                    break;
+                }
+                const Vec3d w = delta.head<3>();
+                const double angle = w.norm();
+                const Mat3d dR = angle > 0.0 ? Eigen::AngleAxisd(angle, w / angle).toRotationMatrix()
+                                             : Mat3d::Identity();
+                const Mat3d newR = dR * R;
+                const Vec3d newT = t + delta.tail<3>();
+                const double newCost = Cost(newR, newT);
+                if (!(newCost < cost)) {
+                    break;
+                }
+                R = newR;
+                t = newT;
+                cost = newCost;
+            }
+        }
+    }
+
+    ResectionResult Resect(const IntrinsicBase &intrinsic, const Mat3Xd &X, const Mat2Xd &x,
+                           const ResectionOptions &options) {
+        ResectionResult result;
+        const auto n = X.cols();
+        result.correspondences = static_cast<std::size_t>(n);
+        if (n < 3 || x.cols() != n) {
+            return result;
+        }
+        const Mat3Xd bearings = intrinsic(x);
+        const double threshold2 = options.maxReprojError * options.maxReprojError;
+
+        std::mt19937_64 rng(options.seed);
+        std::uniform_int_distribution<Eigen::Index> pick(0, n - 1);
+        std::size_t bestCount = 0;
+        double bestScore = std::numeric_limits<double>::max();
+        Mat3d bestR = Mat3d::Identity();
+        Vec3d bestT = Vec3d::Zero();
+        std::size_t needed = options.maxIterations;
+        std::size_t iter = 0;
+        for (; iter < needed; ++iter) {
+            Eigen::Index idx[3];
+            idx[0] = pick(rng);
+            do {
+                idx[1] = pick(rng);
+            } while (idx[1] == idx[0]);
+            do {
+                idx[2] = pick(rng);
+            } while (idx[2] == idx[0] || idx[2] == idx[1]);
+            Mat3d P, B;
+            for (int j = 0; j < 3; ++j) {
+                P.col(j) = X.col(idx[j]);
+                B.col(j) = bearings.col(idx[j]);
+            }
+            for (const auto &[R, t]: SolveP3P(P, B)) {
+                const Eigen::ArrayXd errors = SquaredErrors(intrinsic, R, t, X, x, bearings);
+                // MSAC score, the inlier count breaks the ties
+                const auto count = static_cast<std::size_t>((errors <= threshold2).count());
+                const double score = errors.min(threshold2).sum();
+                if (count > bestCount || (count == bestCount && score < bestScore)) {
+                    bestCount = count;
+                    bestScore = score;
+                    bestR = R;
+                    bestT = t;
+                    const double ratio = static_cast<double>(count) / static_cast<double>(n);
+                    const double miss = 1.0 - ratio * ratio * ratio;
+                    if (miss <= 0.0) {
+                        needed = 0;
+                    } else if (miss < 1.0) {
+                        const double required = std::log(1.0 - options.confidence) / std::log(miss);
+                        needed = std::min<std::size_t>(options.maxIterations,
+                                                       static_cast<std::size_t>(std::ceil(std::max(required, 1.0))));
+                    }
+                }
+            }
+        }
+        result.iterations = iter;
+        if (bestCount < std::max<std::size_t>(options.minInliers, 3)) {
+            return result;
+        }
+
+        Eigen::ArrayXd errors = SquaredErrors(intrinsic, bestR, bestT, X, x, bearings);
+        std::vector<Eigen::Index> inliers;
+        for (Eigen::Index i = 0; i < n; ++i) {
+            if (errors(i) <= threshold2) {
+                inliers.push_back(i);
+            }
+        }
+        if (options.refineIterations > 0) {
+            RefinePose(X, bearings, inliers, bestR, bestT, options.refineIterations);
+            errors = SquaredErrors(intrinsic, bestR, bestT, X, x, bearings);
+        }
+        double sum = 0.0;
+        std::size_t count = 0;
+        for (Eigen::Index i = 0; i < n; ++i) {
+            if (errors(i) <= threshold2) {
+                sum += errors(i);
+                ++count;
+            }
+        }
+        result.inliers = count;
+        if (count < std::max<std::size_t>(options.minInliers, 3)) {
+            return result;
+        }
+        result.rmse = std::sqrt(sum / static_cast<double>(count));
+        result.pose = Posed(bestR, bestT);
+        result.success = true;
+        return result;
+    }
+
+    ResectionReport ResectViews(Veta &veta, const ViewLandmarks &viewLandmarks, const ResectionOptions &options) {
+        // views with an intrinsic
+        struct Item {
+            IndexT viewId;
+            const View *view;
+            const IntrinsicBase *intrinsic;
+        };
+        std::vector<Item> items;
+        for (const auto &[viewId, lmIds]: viewLandmarks) {
+            auto viewIter = veta.views.find(viewId);
+            if (viewIter == veta.views.cend() || !viewIter->second) {
+                continue;
+            }
+            auto intrinsicIter = veta.intrinsics.find(viewIter->second->intrinsicId);
+            if (intrinsicIter == veta.intrinsics.cend() || !intrinsicIter->second) {
+                continue;
+            }
+            items.push_back({viewId, viewIter->second.get(), intrinsicIter->second.get()});
+        }
+
+        std::vector<ResectionResult> results(items.size());
+        ParallelFor(0, items.size(), [&](std::size_t i) {
+            const IndexT viewId = items[i].viewId;
+            const std::vector<IndexT> &lmIds = viewLandmarks.at(viewId);
+            Mat3Xd X(3, lmIds.size());
+            Mat2Xd x(2, lmIds.size());
+            Eigen::Index count = 0;
+            for (const IndexT lmId: lmIds) {
+                auto lmIter = veta.structure.find(lmId);
+                if (lmIter == veta.structure.cend()) {
+                    continue;
+                }
+                auto obsIter = lmIter->second.obs.find(viewId);
+                if (obsIter == lmIter->second.obs.cend()) {
+                    continue;
+                }
+                X.col(count) = lmIter->second.X;
+                x.col(count) = obsIter->second.x.cast<double>();
+                ++count;
+            }
+            X.conservativeResize(3, count);
+            x.conservativeResize(2, count);
+            // the samples of a view only depend on the seed of the options and on the view id
+            ResectionOptions viewOptions = options;
+            std::size_t seed = options.seed;
+            HashCombine(seed, viewId);
+            viewOptions.seed = seed;
+            results[i] = Resect(*items[i].intrinsic, X, x, viewOptions);
+        }, 1);
+
+        ResectionReport report;
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            const IndexT poseId = items[i].view->poseId;
+            if (options.writeBack && results[i].success && poseId != UndefinedIndexT) {
+                veta.poses.insert_or_assign(poseId, results[i].pose);
+            }
+            report.emplace_hint(report.end(), items[i].viewId, results[i]);
+        }
+        return report;
+    }
+}
@@ -0,0 +1,149 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/sharded_landmarks.h"
+#include <queue>
+
+namespace ns_veta {
+
+    ShardedLandmarks::ShardedLandmarks(std::size_t shardCount, ShardPolicy policy)
+            : policy(policy), shards(shardCount ? shardCount : HardwareThreads()) {
+        // all the ids go to the first shard until the ranges are balanced
+        bounds.assign(shards.size(), UndefinedIndexT);
+        bounds.front() = 0;
+    }
+
+    ShardedLandmarks::Ptr ShardedLandmarks::Create(std::size_t shardCount, ShardPolicy policy) {
+        return std::make_shared<ShardedLandmarks>(shardCount, policy);
+    }
+
+    ShardedLandmarks ShardedLandmarks::Partition(Landmarks &&structure, std::size_t shardCount, ShardPolicy policy) {
+        ShardedLandmarks sharded(shardCount, policy);
+        sharded.Distribute(std::move(structure));
+        return sharded;
+    }
+
+    void ShardedLandmarks::Distribute(Landmarks &&structure) {
+        // nodes are only moved between maps of equal allocators
+        for (Landmarks &shard: shards) {
+            shard = Landmarks(structure.get_allocator());
+        }
+        const std::size_t count = structure.size(), shardCount = shards.size();
+
+        if (policy == ShardPolicy::HASH) {
+            // the ids are visited by increasing order, so that each insertion is amortized constant
+            while (!structure.empty()) {
+                auto node = structure.extract(structure.begin());
+                Landmarks &shard = shards[ShardOf(node.key())];
+                shard.insert(shard.end(), std::move(node));
+            }
+            return;
+        }
+
+        // ID_RANGE: shard 's' starts at the landmark of rank 's * count / shardCount'
+        bounds.assign(shardCount, UndefinedIndexT);
+        bounds.front() = 0;
+        std::size_t rank = 0, s = 0;
+        for (const auto &[lmId, lm]: structure) {
+            while (s + 1 < shardCount && rank == (s + 1) * count / shardCount) {
+                bounds[++s] = lmId;
+            }
+            ++rank;
+        }
+        s = 0;
+        while (!structure.empty()) {
+            auto node = structure.extract(structure.begin());
+            while (s + 1 < shardCount && bounds[s + 1] <= node.key()) {
+                ++s;
+            }
+            shards[s].insert(shards[s].end(), std::move(node));
+        }
+    }
+
+    Landmarks ShardedLandmarks::Join() {
+        Landmarks structure(shards.front().get_allocator());
+        if (policy == ShardPolicy::ID_RANGE) {
+            for (Landmarks &shard: shards) {
+                while (!shard.empty()) {
+                    structure.insert(structure.end(), shard.extract(shard.begin()));
+                }
+            }
+            return structure;
+        }
+        // HASH: k-way merge of the shards, so that each insertion is amortized constant
+        using Head = std::pair<IndexT, std::size_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+        for (std::size_t s = 0; s < shards.size(); ++s) {
+            if (!shards[s].empty()) {
+                heads.emplace(shards[s].begin()->first, s);
+            }
+        }
+        while (!heads.empty()) {
+            Landmarks &shard = shards[heads.top().second];
+            heads.pop();
+            structure.insert(structure.end(), shard.extract(shard.begin()));
+            if (!shard.empty()) {
+                heads.emplace(shard.begin()->first, &shard - shards.data());
+            }
+        }
+        return structure;
+    }
+
+    void ShardedLandmarks::Rebalance() {
+        if (policy == ShardPolicy::ID_RANGE) {
+            Distribute(Join());
+        }
+    }
+
+    ShardPolicy ShardedLandmarks::Policy() const {
+        return policy;
+    }
+
+    std::size_t ShardedLandmarks::ShardCount() const {
+        return shards.size();
+    }
+
+    std::size_t ShardedLandmarks::Size() const {
+        std::size_t size = 0;
+        for (const Landmarks &shard: shards) {
+            size += shard.size();
+        }
+        return size;
+    }
+
+    std::size_t ShardedLandmarks::ShardOf(IndexT lmId) const {
+        if (policy == ShardPolicy::HASH) {
+            return std::hash<IndexT>()(lmId) % shards.size();
+        }
+        return std::upper_bound(bounds.cbegin(), bounds.cend(), lmId) - bounds.cbegin() - 1;
+    }
+
+    const Landmarks &ShardedLandmarks::Shard(std::size_t s) const {
+        return shards.at(s);
+    }
+
+    Landmarks &ShardedLandmarks::Shard(std::size_t s) {
+        return shards.at(s);
+    }
+
+    const Landmark *ShardedLandmarks::Find(IndexT lmId) const {
+        const Landmarks &shard = shards[ShardOf(lmId)];
+        auto iter = shard.find(lmId);
+        return iter == shard.cend() ? nullptr : &iter->second;
+    }
+
+    Landmark *ShardedLandmarks::Find(IndexT lmId) {
+        Landmarks &shard = shards[ShardOf(lmId)];
+        auto iter = shard.find(lmId);
+        return iter == shard.end() ? nullptr : &iter->second;
+    }
+
+    Landmark &ShardedLandmarks::Insert(IndexT lmId, Landmark lm) {
+        return shards[ShardOf(lmId)].insert_or_assign(lmId, std::move(lm)).first->second;
+    }
+
+    bool ShardedLandmarks::Erase(IndexT lmId) {
+        return shards[ShardOf(lmId)].erase(lmId) != 0;
+    }
+}
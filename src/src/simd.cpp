@@ -0,0 +1,92 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include <atomic>
+#include "veta/simd.h"
+#include "simd/kernels.h"
+
+namespace ns_veta {
+
+    namespace {
+        // x86 feature detection, also checks that the OS saves the wide registers
+        bool CpuSupports(SimdLevel level) {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+            switch (level) {
+                case SimdLevel::SCALAR:
+                    return true;
+                case SimdLevel::AVX2:
+                    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+                case SimdLevel::AVX512:
+                    return __builtin_cpu_supports("avx512f");
+            }
+            return false;
+#else
+            return level == SimdLevel::SCALAR;
+#endif
+        }
+
+        std::atomic<const SimdKernels *> &Selected() {
+            static std::atomic<const SimdKernels *> selected{nullptr};
+            return selected;
+        }
+    }
+
+    const SimdKernels *SimdDispatch::Find(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::SCALAR:
+                return &simd_scalar::kernels;
+            case SimdLevel::AVX2:
+#ifdef VETA_SIMD_AVX2
+                return &simd_avx2::kernels;
+#else
+                return nullptr;
+#endif
+            case SimdLevel::AVX512:
+#ifdef VETA_SIMD_AVX512
+                return &simd_avx512::kernels;
+#else
+                return nullptr;
+#endif
+        }
+        return nullptr;
+    }
+
+    bool SimdDispatch::Supported(SimdLevel level) {
+        return Find(level) != nullptr && CpuSupports(level);
+    }
+
+    const SimdKernels &SimdDispatch::Kernels() {
+        const SimdKernels *kernels = Selected().load(std::memory_order_acquire);
+        if (kernels == nullptr) {
+            // the widest supported variant
+            for (SimdLevel level: {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SCALAR}) {
+                if (Supported(level)) {
+                    kernels = Find(level);
+                    break;
+                }
+            }
+            // concurrent first calls detect the same variant
+            const SimdKernels *expected = nullptr;
+            Selected().compare_exchange_strong(expected, kernels, std::memory_order_acq_rel);
+            kernels = Selected().load(std::memory_order_acquire);
+        }
+        return *kernels;
+    }
+
+    SimdLevel SimdDispatch::Level() {
+        return Kernels().level;
+    }
+
+    std::string SimdDispatch::Name() {
+        return Kernels().name;
+    }
+
+    bool SimdDispatch::Select(SimdLevel level) {
+        if (!Supported(level)) {
+            return false;
+        }
+        Selected().store(Find(level), std::memory_order_release);
+        return true;
+    }
+}
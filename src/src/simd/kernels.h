@@ -0,0 +1,23 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_SIMD_KERNELS_H
+#define VETA_SIMD_KERNELS_H
+
+#include "veta/simd.h"
+
+// the kernel tables of the compiled variants, each one defined by 'kernels.inl' compiled with its own flags
+namespace ns_veta::simd_scalar {
+    extern const SimdKernels kernels;
+}
+
+namespace ns_veta::simd_avx2 {
+    extern const SimdKernels kernels;
+}
+
+namespace ns_veta::simd_avx512 {
+    extern const SimdKernels kernels;
+}
+
+#endif //VETA_SIMD_KERNELS_H
@@ -0,0 +1,339 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// Body of the batched kernels, included by 'kernels_<variant>.cpp' which are compiled with the flags of their
+// instruction set and define 'VETA_SIMD_NAMESPACE', 'VETA_SIMD_LEVEL' and 'VETA_SIMD_NAME'. The kernels are
+// plain loops over raw arrays left to the auto-vectorizer: no inline function of a header (e.g. Eigen, or the
+// overloads of <cmath>) is used here, as its instantiation could be shared with (and picked by the linker for) a
+// translation unit compiled without the flags, the math functions are called in their '__builtin_' forms. The
+// variants are also compiled with '-fno-trapping-math', so that the selects between divisions (or 'floor') are
+// if-converted and the loops vectorized, and with '-fno-math-errno', so that 'sqrt' is inlined; the results are
+// unchanged.
+
+#include "kernels.h"
+
+namespace ns_veta::VETA_SIMD_NAMESPACE {
+
+    namespace {
+        // pi/2 split in two parts, the first one with 33 significant bits
+        constexpr double twoOverPi = 6.36619772367581382433e-01;
+        constexpr double pio2Hi = 1.57079632673412561417e+00, pio2Lo = 6.07710050650619224932e-11;
+        constexpr double pi = 3.14159265358979323846, pio2 = 1.57079632679489661923;
+        constexpr double pio4 = 7.85398163397448309616e-01, moreBits = 6.123233995736765886130e-17;
+
+        // the element-wise cores of the kernels below, internal to this variant so that they are compiled with its
+        // flags and inlined into its loops
+
+        inline void SinCosOne(double x, double &sin, double &cos) {
+            // x = k * pi/2 + r, |r| <= pi/4
+            const double k = __builtin_floor(x * twoOverPi + 0.5);
+            const double r = (x - k * pio2Hi) - k * pio2Lo;
+            const double z = r * r;
+
+            // Taylor polynomials, the truncation error is below 1E-16 on [-pi/4, pi/4]
+            const double sinR = r + r * z * (-1.66666666666666666667e-01 + z * (
+                    8.33333333333333333333e-03 + z * (-1.98412698412698412698e-04 + z * (
+                    2.75573192239858906526e-06 + z * (-2.50521083854417187751e-08 + z * (
+                    1.60590438368216145994e-10 + z * -7.64716373181981647590e-13))))));
+            const double cosR = 1.0 + z * (-0.5 + z * (4.16666666666666666667e-02 + z * (
+                    -1.38888888888888888889e-03 + z * (2.48015873015873015873e-05 + z * (
+                    -2.75573192239858906526e-07 + z * (2.08767569878680989792e-09 + z * (
+                    -1.14707455977297247139e-11 + z * 4.77947733238738529744e-14)))))));
+
+            // quadrant of x
+            const double q = k - 4.0 * __builtin_floor(k * 0.25);
+            const bool swap = q == 1.0 || q == 3.0;
+            const double s = swap ? cosR : sinR, c = swap ? sinR : cosR;
+            sin = q >= 2.0 ? -s : s;
+            cos = q == 1.0 || q == 2.0 ? -c : c;
+        }
+
+        inline double Atan2One(double y, double x) {
+            const double ax = x < 0.0 ? -x : x, ay = y < 0.0 ? -y : y;
+            const double hi = ax > ay ? ax : ay, lo = ax > ay ? ay : ax;
+            const double t = hi > 0.0 ? lo / hi : 0.0;
+
+            // atan(t) = pi/4 + atan((t - 1) / (t + 1)) for t > 0.66, then the rational approximation
+            // u + u * z * P(z) / Q(z) on [-0.2, 0.66] (Cephes 'atan')
+            const bool reduce = t > 0.66;
+            const double u = reduce ? (t - 1.0) / (t + 1.0) : t;
+            const double z = u * u;
+            const double P = -6.485021904942025371773e+01 + z * (-1.228866684490136173410e+02 + z * (
+                    -7.500855792314704667340e+01 + z * (-1.615753718733365076637e+01 + z *
+                                                                                       -8.750608600031904122785e-01)));
+            const double Q = 1.945506571482613964425e+02 + z * (4.853903996359136964868e+02 + z * (
+                    4.328810604912902668951e+02 + z * (1.650270098316988542046e+02 + z * (
+                    2.485846490142306297962e+01 + z))));
+            const double atanU = u + u * z * P / Q;
+            double r = reduce ? pio4 + (atanU + 0.5 * moreBits) : atanU;
+
+            // back to the octant and the quadrant, the signs of the zeros count as for 'std::atan2' ('copysign'
+            // is a bit operation, unlike 'signbit' it keeps the loops vectorized)
+            r = ay > ax ? pio2 - r : r;
+            r = __builtin_copysign(1.0, x) < 0.0 ? pi - r : r;
+            return __builtin_copysign(r, y);
+        }
+
+        template<std::size_t N>
+        void ProjectRadialN(const double *params, const double *X, double *x, std::size_t n) {
+            const double fx = params[0], fy = params[1], cx = params[2], cy = params[3];
+            double k[N + 1];
+            for (std::size_t j = 0; j < N; ++j) {
+                k[j] = params[4 + j];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                const double iz = 1.0 / X[3 * i + 2];
+                const double u = X[3 * i] * iz, v = X[3 * i + 1] * iz;
+                const double r2 = u * u + v * v;
+                double poly = 0.0;
+                for (std::size_t j = N; j-- > 0;) {
+                    poly = k[j] + r2 * poly;
+                }
+                poly = 1.0 + r2 * poly;
+                x[2 * i] = fx * u * poly + cx;
+                x[2 * i + 1] = fy * v * poly + cy;
+            }
+        }
+
+        void TransformPoints(const double *R, const double *t, const double *X, double *Y, std::size_t n) {
+            const double r00 = R[0], r10 = R[1], r20 = R[2], r01 = R[3], r11 = R[4], r21 = R[5];
+            const double r02 = R[6], r12 = R[7], r22 = R[8], t0 = t[0], t1 = t[1], t2 = t[2];
+            for (std::size_t i = 0; i < n; ++i) {
+                const double px = X[3 * i], py = X[3 * i + 1], pz = X[3 * i + 2];
+                Y[3 * i] = r00 * px + r01 * py + r02 * pz + t0;
+                Y[3 * i + 1] = r10 * px + r11 * py + r12 * pz + t1;
+                Y[3 * i + 2] = r20 * px + r21 * py + r22 * pz + t2;
+            }
+        }
+
+        void ProjectRadial(const double *params, std::size_t distoCount, const double *X, double *x, std::size_t n) {
+            switch (distoCount) {
+                case 0:
+                    return ProjectRadialN<0>(params, X, x, n);
+                case 1:
+                    return ProjectRadialN<1>(params, X, x, n);
+                case 2:
+                    return ProjectRadialN<2>(params, X, x, n);
+                case 3:
+                    return ProjectRadialN<3>(params, X, x, n);
+                default:
+                    break;
+            }
+            const double fx = params[0], fy = params[1], cx = params[2], cy = params[3];
+            for (std::size_t i = 0; i < n; ++i) {
+                const double iz = 1.0 / X[3 * i + 2];
+                const double u = X[3 * i] * iz, v = X[3 * i + 1] * iz;
+                const double r2 = u * u + v * v;
+                double poly = 0.0;
+                for (std::size_t j = distoCount; j-- > 0;) {
+                    poly = params[4 + j] + r2 * poly;
+                }
+                poly = 1.0 + r2 * poly;
+                x[2 * i] = fx * u * poly + cx;
+                x[2 * i + 1] = fy * v * poly + cy;
+            }
+        }
+
+        void ProjectBrown(const double *params, const double *X, double *x, std::size_t n) {
+            const double fx = params[0], fy = params[1], cx = params[2], cy = params[3];
+            const double k1 = params[4], k2 = params[5], k3 = params[6], t1 = params[7], t2 = params[8];
+            for (std::size_t i = 0; i < n; ++i) {
+                const double iz = 1.0 / X[3 * i + 2];
+                const double u = X[3 * i] * iz, v = X[3 * i + 1] * iz;
+                const double r2 = u * u + v * v;
+                const double kDiff = r2 * (k1 + r2 * (k2 + r2 * k3));
+                const double tx = t2 * (r2 + 2.0 * u * u) + 2.0 * t1 * u * v;
+                const double ty = t1 * (r2 + 2.0 * v * v) + 2.0 * t2 * u * v;
+                x[2 * i] = fx * (u + u * kDiff + tx) + cx;
+                x[2 * i + 1] = fy * (v + v * kDiff + ty) + cy;
+            }
+        }
+
+        void ProjectFisheye(const double *params, const double *X, double *x, std::size_t n) {
+            constexpr double eps = 1e-8;
+            const double fx = params[0], fy = params[1], cx = params[2], cy = params[3];
+            const double k1 = params[4], k2 = params[5], k3 = params[6], k4 = params[7];
+            for (std::size_t i = 0; i < n; ++i) {
+                const double iz = 1.0 / X[3 * i + 2];
+                const double u = X[3 * i] * iz, v = X[3 * i + 1] * iz;
+                const double r = __builtin_sqrt(u * u + v * v);
+                const double theta = Atan2One(r, 1.0), theta2 = theta * theta;
+                // theta + k1 * theta^3 + k2 * theta^5 + k3 * theta^7 + k4 * theta^9
+                const double thetaDist = theta * (1.0 + theta2 * (k1 + theta2 * (k2 + theta2 * (k3 + theta2 * k4))));
+                const double cDist = r > eps ? thetaDist / r : 1.0;
+                x[2 * i] = fx * u * cDist + cx;
+                x[2 * i + 1] = fy * v * cDist + cy;
+            }
+        }
+
+        // the iterative solvers run on blocks of points, each iteration on all the points of the block until they
+        // all converged, so that the loops over the points vectorize
+        constexpr std::size_t SolveBlock = 256;
+
+        template<std::size_t N>
+        void RemoveRadialDistoN(const double *disto, const double *p, double *u, unsigned char *converged,
+                                std::size_t n) {
+            constexpr double epsilon = 1e-12;
+            double k[N];
+            for (std::size_t j = 0; j < N; ++j) {
+                k[j] = disto[j];
+            }
+            double rd[SolveBlock], ru[SolveBlock], slope[SolveBlock];
+            for (std::size_t b = 0; b < n; b += SolveBlock) {
+                const std::size_t m = n - b < SolveBlock ? n - b : SolveBlock;
+                const double *pb = p + 2 * b;
+                for (std::size_t i = 0; i < m; ++i) {
+                    rd[i] = __builtin_sqrt(pb[2 * i] * pb[2 * i] + pb[2 * i + 1] * pb[2 * i + 1]);
+                    ru[i] = rd[i];
+                    slope[i] = 1.0;
+                }
+                // Newton iterations on r_u * (1 + k1 * r_u^2 + ... + kN * r_u^2N) = r_d
+                for (int iter = 0; iter < 20; ++iter) {
+                    int more = 0;
+                    for (std::size_t i = 0; i < m; ++i) {
+                        const double r2 = ru[i] * ru[i];
+                        double poly = 0.0, deriv = 0.0;
+                        for (std::size_t j = N; j-- > 0;) {
+                            poly = k[j] + r2 * poly;
+                            deriv = double(j + 1) * k[j] + r2 * deriv;
+                        }
+                        poly = 1.0 + r2 * poly;
+                        slope[i] = poly + 2.0 * r2 * deriv;
+                        const double step = (ru[i] * poly - rd[i]) / slope[i];
+                        ru[i] -= step;
+                        more |= __builtin_fabs(step) > epsilon;
+                    }
+                    if (!more) {
+                        break;
+                    }
+                }
+                for (std::size_t i = 0; i < m; ++i) {
+                    const double r2 = ru[i] * ru[i];
+                    double poly = 0.0;
+                    for (std::size_t j = N; j-- > 0;) {
+                        poly = k[j] + r2 * poly;
+                    }
+                    poly = 1.0 + r2 * poly;
+                    const double error = __builtin_fabs(ru[i] * poly - rd[i]);
+                    converged[b + i] = error <= epsilon * (rd[i] > 1.0 ? rd[i] : 1.0) && slope[i] > 0.0 && ru[i] >= 0.0;
+                    const double scale = rd[i] > 0.0 ? ru[i] / rd[i] : 1.0;
+                    u[2 * (b + i)] = pb[2 * i] * scale;
+                    u[2 * (b + i) + 1] = pb[2 * i + 1] * scale;
+                }
+            }
+        }
+
+        void RemoveRadialDisto(const double *disto, std::size_t distoCount, const double *p, double *u,
+                               unsigned char *converged, std::size_t n) {
+            switch (distoCount) {
+                case 1:
+                    return RemoveRadialDistoN<1>(disto, p, u, converged, n);
+                case 2:
+                    return RemoveRadialDistoN<2>(disto, p, u, converged, n);
+                case 3:
+                    return RemoveRadialDistoN<3>(disto, p, u, converged, n);
+                case 4:
+                    return RemoveRadialDistoN<4>(disto, p, u, converged, n);
+                case 5:
+                    return RemoveRadialDistoN<5>(disto, p, u, converged, n);
+                default:
+                    break;
+            }
+            for (std::size_t i = 0; i < 2 * n; ++i) {
+                u[i] = p[i];
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                converged[i] = 1;
+            }
+        }
+
+        void RemoveBrownDisto(const double *disto, const double *p, double *u, unsigned char *converged,
+                              std::size_t n) {
+            constexpr double epsilon = 1e-10;
+            const double k1 = disto[0], k2 = disto[1], k3 = disto[2], t1 = disto[3], t2 = disto[4];
+            double x[SolveBlock], y[SolveBlock], error[SolveBlock];
+            for (std::size_t b = 0; b < n; b += SolveBlock) {
+                const std::size_t m = n - b < SolveBlock ? n - b : SolveBlock;
+                const double *pb = p + 2 * b;
+                for (std::size_t i = 0; i < m; ++i) {
+                    x[i] = pb[2 * i];
+                    y[i] = pb[2 * i + 1];
+                }
+                // Newton iterations on p_u + disto(p_u) = p
+                for (int iter = 0; iter < 20; ++iter) {
+                    int more = 0;
+                    for (std::size_t i = 0; i < m; ++i) {
+                        const double xi = x[i], yi = y[i];
+                        const double r2 = xi * xi + yi * yi;
+                        const double kDiff = r2 * (k1 + r2 * (k2 + r2 * k3));
+                        const double dkDiff = k1 + r2 * (2.0 * k2 + 3.0 * k3 * r2);
+                        const double fx = xi + xi * kDiff + t2 * (r2 + 2.0 * xi * xi) + 2.0 * t1 * xi * yi - pb[2 * i];
+                        const double fy = yi + yi * kDiff + t1 * (r2 + 2.0 * yi * yi) + 2.0 * t2 * xi * yi -
+                                          pb[2 * i + 1];
+                        error[i] = __builtin_fabs(fx) + __builtin_fabs(fy);
+                        // written so that NaN errors keep iterating
+                        more |= !(error[i] <= epsilon);
+                        // jacobian (symmetric)
+                        const double jxx = 1.0 + kDiff + 2.0 * xi * xi * dkDiff + 6.0 * t2 * xi + 2.0 * t1 * yi;
+                        const double jyy = 1.0 + kDiff + 2.0 * yi * yi * dkDiff + 6.0 * t1 * yi + 2.0 * t2 * xi;
+                        const double jxy = 2.0 * xi * yi * dkDiff + 2.0 * t1 * xi + 2.0 * t2 * yi;
+                        const double det = jxx * jyy - jxy * jxy;
+                        x[i] = xi - (jyy * fx - jxy * fy) / det;
+                        y[i] = yi - (jxx * fy - jxy * fx) / det;
+                    }
+                    if (!more) {
+                        break;
+                    }
+                }
+                for (std::size_t i = 0; i < m; ++i) {
+                    converged[b + i] = error[i] <= epsilon;
+                    u[2 * (b + i)] = x[i];
+                    u[2 * (b + i) + 1] = y[i];
+                }
+            }
+        }
+
+        void RemoveFisheyeDisto(const double *disto, const double *p, double *u, std::size_t n) {
+            constexpr double eps = 1e-8;
+            const double k1 = disto[0], k2 = disto[1], k3 = disto[2], k4 = disto[3];
+            for (std::size_t i = 0; i < n; ++i) {
+                const double thetaDist = __builtin_sqrt(p[2 * i] * p[2 * i] + p[2 * i + 1] * p[2 * i + 1]);
+                // fixed point iterations on theta * (1 + k1 * theta^2 + ... + k4 * theta^8) = theta_d
+                double theta = thetaDist;
+                for (int j = 0; j < 10; ++j) {
+                    const double theta2 = theta * theta;
+                    theta = thetaDist / (1.0 + theta2 * (k1 + theta2 * (k2 + theta2 * (k3 + theta2 * k4))));
+                }
+                double sin, cos;
+                SinCosOne(theta, sin, cos);
+                const double scale = thetaDist > eps ? sin / (cos * thetaDist) : 1.0;
+                u[2 * i] = p[2 * i] * scale;
+                u[2 * i + 1] = p[2 * i + 1] * scale;
+            }
+        }
+
+        void Residuals(const double *x, double *r, std::size_t n) {
+            for (std::size_t i = 0; i < 2 * n; ++i) {
+                r[i] = x[i] - r[i];
+            }
+        }
+
+        void SinCos(const double *x, double *sin, double *cos, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                SinCosOne(x[i], sin[i], cos[i]);
+            }
+        }
+
+        void Atan2(const double *y, const double *x, double *a, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                a[i] = Atan2One(y[i], x[i]);
+            }
+        }
+    }
+
+    const SimdKernels kernels{
+            VETA_SIMD_LEVEL, VETA_SIMD_NAME, TransformPoints, ProjectRadial, ProjectBrown, ProjectFisheye,
+            RemoveRadialDisto, RemoveBrownDisto, RemoveFisheyeDisto, Residuals, SinCos, Atan2
+    };
+}
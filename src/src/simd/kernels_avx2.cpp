@@ -0,0 +1,10 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// the 'avx2' variant of the batched kernels (see 'kernels.inl')
+#define VETA_SIMD_NAMESPACE simd_avx2
+#define VETA_SIMD_LEVEL SimdLevel::AVX2
+#define VETA_SIMD_NAME "avx2"
+
+#include "kernels.inl"
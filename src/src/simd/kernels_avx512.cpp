@@ -0,0 +1,10 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// the 'avx512' variant of the batched kernels (see 'kernels.inl')
+#define VETA_SIMD_NAMESPACE simd_avx512
+#define VETA_SIMD_LEVEL SimdLevel::AVX512
+#define VETA_SIMD_NAME "avx512"
+
+#include "kernels.inl"
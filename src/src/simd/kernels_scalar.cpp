@@ -0,0 +1,10 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// the 'scalar' variant of the batched kernels (see 'kernels.inl')
+#define VETA_SIMD_NAMESPACE simd_scalar
+#define VETA_SIMD_LEVEL SimdLevel::SCALAR
+#define VETA_SIMD_NAME "scalar"
+
+#include "kernels.inl"
@@ -0,0 +1,59 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/similarity.h"
+#include "veta/simd.h"
+#include "veta/utils.hpp"
+
+namespace ns_veta {
+
+    namespace {
+        Sophus::SO3d SimRotation(const Sophus::Sim3d &sim) {
+            // the quaternion of 'RxSO3' has a norm of sqrt(scale)
+            return Sophus::SO3d(sim.rxso3().quaternion().normalized());
+        }
+    }
+
+    Posed TransformPose(const Posed &worldToCam, const Sophus::Sim3d &sim) {
+        // x_c' = s * x_c = s * (R_c * R_s^T * (X' - t_s) / s + t_c)
+        const Sophus::SO3d rotation = worldToCam.Rotation() * SimRotation(sim).inverse();
+        return Posed(rotation, sim.scale() * worldToCam.Translation() - rotation * sim.translation());
+    }
+
+    void ApplySimilarity(Veta &veta, const Sophus::Sim3d &sim) {
+        // poses
+        std::vector<Posed *> poses;
+        poses.reserve(veta.poses.size());
+        for (auto &[poseId, pose]: veta.poses) {
+            poses.push_back(&pose);
+        }
+        ParallelFor(0, poses.size(), [&](std::size_t i) {
+            *poses[i] = TransformPose(*poses[i], sim);
+        }, 4096);
+
+        // structure, transformed by batches of contiguous points
+        std::vector<Landmark *> landmarks;
+        landmarks.reserve(veta.structure.size());
+        for (auto &[lmId, lm]: veta.structure) {
+            landmarks.push_back(&lm);
+        }
+        const Mat3d sR = sim.scale() * sim.rotationMatrix();
+        const Vec3d &simTrans = sim.translation();
+        const SimdKernels &kernels = SimdDispatch::Kernels();
+        constexpr std::size_t BatchSize = 1024;
+        ParallelForRange(0, landmarks.size(), [&](std::size_t lo, std::size_t hi, std::size_t) {
+            Mat3Xd X(3, BatchSize), Y(3, BatchSize);
+            for (std::size_t begin = lo; begin < hi; begin += BatchSize) {
+                const std::size_t count = std::min(BatchSize, hi - begin);
+                for (std::size_t j = 0; j < count; ++j) {
+                    X.col(static_cast<Eigen::Index>(j)) = landmarks[begin + j]->X;
+                }
+                kernels.transformPoints(sR.data(), simTrans.data(), X.data(), Y.data(), count);
+                for (std::size_t j = 0; j < count; ++j) {
+                    landmarks[begin + j]->X = Y.col(static_cast<Eigen::Index>(j));
+                }
+            }
+        }, 1 << 14);
+    }
+}
@@ -0,0 +1,78 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/snapshot.h"
+
+namespace ns_veta {
+
+    // -----------
+    // VetaVersion
+    // -----------
+
+    VetaVersion::VetaVersion(const Veta &veta) {
+        // the views and intrinsics are copied, so that the ones of the scene can still be modified in place
+        for (const auto &[viewId, view]: veta.views) {
+            views.Insert(viewId, view ? std::make_shared<const View>(*view) : nullptr);
+        }
+        for (const auto &[poseId, pose]: veta.poses) {
+            poses.Insert(poseId, pose);
+        }
+        for (const auto &[intrinsicId, intrinsic]: veta.intrinsics) {
+            intrinsics.Insert(intrinsicId, intrinsic ? std::shared_ptr<const IntrinsicBase>(intrinsic->Clone())
+                                                     : nullptr);
+        }
+        for (const auto &[lmId, lm]: veta.structure) {
+            structure.Insert(lmId, lm);
+        }
+    }
+
+    Veta VetaVersion::Materialize() const {
+        Veta veta;
+        views.ForEach([&veta](IndexT viewId, const std::shared_ptr<const View> &view) {
+            veta.views.emplace_hint(veta.views.end(), viewId, view ? std::make_shared<View>(*view) : nullptr);
+        });
+        poses.ForEach([&veta](IndexT poseId, const Posed &pose) {
+            veta.poses.emplace_hint(veta.poses.end(), poseId, pose);
+        });
+        intrinsics.ForEach([&veta](IndexT intrinsicId, const std::shared_ptr<const IntrinsicBase> &intrinsic) {
+            veta.intrinsics.emplace_hint(veta.intrinsics.end(), intrinsicId,
+                                         intrinsic ? std::shared_ptr<IntrinsicBase>(intrinsic->Clone()) : nullptr);
+        });
+        structure.ForEach([&veta](IndexT lmId, const Landmark &lm) {
+            veta.structure.emplace_hint(veta.structure.end(), lmId, lm);
+        });
+        return veta;
+    }
+
+    // ----------
+    // SharedVeta
+    // ----------
+
+    SharedVeta::SharedVeta() : published(std::make_shared<const VetaVersion>()) {}
+
+    SharedVeta::SharedVeta(const Veta &veta) : working(veta), published(std::make_shared<const VetaVersion>(working)) {}
+
+    SharedVeta::Ptr SharedVeta::Create(const Veta &veta) {
+        return std::make_shared<SharedVeta>(veta);
+    }
+
+    VetaVersion &SharedVeta::Working() {
+        return working;
+    }
+
+    const VetaVersion &SharedVeta::Working() const {
+        return working;
+    }
+
+    VetaVersion::Ptr SharedVeta::Publish() {
+        ++working.version;
+        auto version = std::make_shared<const VetaVersion>(working);
+        std::atomic_store(&published, version);
+        return version;
+    }
+
+    VetaVersion::Ptr SharedVeta::Snapshot() const {
+        return std::atomic_load(&published);
+    }
+}
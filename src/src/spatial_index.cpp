@@ -0,0 +1,411 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/spatial_index.h"
+
+namespace ns_veta {
+
+    // -------
+    // Frustum
+    // -------
+
+    Frustum Frustum::FromView(const Posed &worldToCam, const IntrinsicBase &intrinsic,
+                              double nearDist, double farDist) {
+        return FromView(worldToCam, intrinsic, intrinsic.Width(), intrinsic.Height(), nearDist, farDist);
+    }
+
+    Frustum Frustum::FromView(const Posed &worldToCam, const IntrinsicBase &intrinsic, double width, double height,
+                              double nearDist, double farDist) {
+        const Mat3d rotT = worldToCam.Rotation().matrix().transpose();
+        const Vec3d center = -rotT * worldToCam.Translation();
+        const Vec3d axis = rotT.col(2);
+
+        // sample the image border and bound the bearings by a rectangle of the normalized plane,
+        // so that the frustum holds the whole image even if the border is curved by the distortion
+        const int samples = 8;
+        const double w = width, h = height;
+        Mat2Xd border(2, 4 * samples);
+        for (int i = 0; i < samples; ++i) {
+            const double s = static_cast<double>(i) / samples;
+            border.col(4 * i + 0) << s * w, 0.0;
+            border.col(4 * i + 1) << w, s * h;
+            border.col(4 * i + 2) << (1.0 - s) * w, h;
+            border.col(4 * i + 3) << 0.0, (1.0 - s) * h;
+        }
+        Mat2Xd normalized(2, border.cols());
+        for (Mat2Xd::Index i = 0; i < border.cols(); ++i) {
+            normalized.col(i) = intrinsic.RemoveDisto(intrinsic.ImgToCam(border.col(i)));
+        }
+        const Vec2d lower = normalized.rowwise().minCoeff(), upper = normalized.rowwise().maxCoeff();
+        // rectangle corners in clockwise order
+        Mat3Xd corners(3, 4);
+        corners << lower(0), upper(0), upper(0), lower(0),
+                lower(1), lower(1), upper(1), upper(1),
+                1.0, 1.0, 1.0, 1.0;
+        const Mat3Xd dirs = rotT * corners;
+
+        Frustum frustum;
+        frustum.planes[0] << axis, -axis.dot(center + nearDist * axis);
+        if (farDist < std::numeric_limits<double>::max()) {
+            frustum.planes[1] << -axis, axis.dot(center + farDist * axis);
+        } else {
+            // always satisfied
+            frustum.planes[1] << Vec3d::Zero(), 1.0;
+        }
+        // the side planes go through the center, they are oriented towards the direction of the rectangle center,
+        // which is interior even if the principal point lies outside the image (unlike the optical axis)
+        const Vec3d interiorDir = rotT * Vec3d(0.5 * (lower(0) + upper(0)), 0.5 * (lower(1) + upper(1)), 1.0);
+        for (int i = 0; i < 4; ++i) {
+            Vec3d normal = dirs.col(i).cross(dirs.col((i + 1) % 4)).normalized();
+            if (normal.dot(interiorDir) < 0.0) {
+                normal = -normal;
+            }
+            frustum.planes[2 + i] << normal, -normal.dot(center);
+        }
+        return frustum;
+    }
+
+    bool Frustum::Contains(const Vec3d &p) const {
+        for (const auto &plane: planes) {
+            if (plane.head<3>().dot(p) + plane(3) < 0.0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Frustum::Classification Frustum::Classify(const AABB &box) const {
+        bool inside = true;
+        for (const auto &plane: planes) {
+            const Vec3d n = plane.head<3>();
+            // the box corners the most (p-vertex) and the least (n-vertex) along the plane normal
+            const Vec3d pv = (n.array() >= 0.0).select(box.max, box.min);
+            const Vec3d nv = (n.array() >= 0.0).select(box.min, box.max);
+            if (n.dot(pv) + plane(3) < 0.0) {
+                return OUTSIDE;
+            }
+            if (n.dot(nv) + plane(3) < 0.0) {
+                inside = false;
+            }
+        }
+        return inside ? INSIDE : INTERSECT;
+    }
+
+    // --------------
+    // LandmarkKdTree
+    // --------------
+
+    namespace {
+        bool NeighborLess(const LandmarkKdTree::Neighbor &a, const LandmarkKdTree::Neighbor &b) {
+            return a.second < b.second;
+        }
+
+        // keep the 'k' nearest neighbors in a max-heap
+        void PushNeighbor(std::vector<LandmarkKdTree::Neighbor> &heap, std::size_t k, IndexT lmId, double d2) {
+            if (heap.size() < k) {
+                heap.emplace_back(lmId, d2);
+                std::push_heap(heap.begin(), heap.end(), NeighborLess);
+            } else if (d2 < heap.front().second) {
+                std::pop_heap(heap.begin(), heap.end(), NeighborLess);
+                heap.back() = {lmId, d2};
+                std::push_heap(heap.begin(), heap.end(), NeighborLess);
+            }
+        }
+    }
+
+    LandmarkKdTree::LandmarkKdTree(std::size_t leafSize) : leafSize(std::max<std::size_t>(leafSize, 1)),
+                                                           erasedCount(0) {}
+
+    LandmarkKdTree::LandmarkKdTree(const Landmarks &structure, std::size_t leafSize)
+            : LandmarkKdTree(leafSize) {
+        Build(structure);
+    }
+
+    LandmarkKdTree::Ptr LandmarkKdTree::Create(const Landmarks &structure, std::size_t leafSize) {
+        return std::make_shared<LandmarkKdTree>(structure, leafSize);
+    }
+
+    std::size_t LandmarkKdTree::CountNodes(std::size_t count, std::size_t leafSize) {
+        if (count <= leafSize) {
+            return 1;
+        }
+        return 1 + CountNodes(count / 2, leafSize) + CountNodes(count - count / 2, leafSize);
+    }
+
+    void LandmarkKdTree::Build(const Landmarks &structure) {
+        const std::size_t count = structure.size();
+        if (count > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("too many landmarks for 'LandmarkKdTree'");
+        }
+        std::vector<Vec3d> srcPoints;
+        std::vector<IndexT> srcIds;
+        srcPoints.reserve(count);
+        srcIds.reserve(count);
+        for (const auto &[lmId, lm]: structure) {
+            srcPoints.push_back(lm.X);
+            srcIds.push_back(lmId);
+        }
+
+        points = std::move(srcPoints);
+        nodes.assign(count ? CountNodes(count, leafSize) : 0, Node());
+        std::vector<uint32_t> order(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            order[i] = i;
+        }
+
+        if (count) {
+            std::size_t parallelDepth = 0;
+            while ((std::size_t(1) << parallelDepth) < HardwareThreads()) {
+                ++parallelDepth;
+            }
+            BuildNode(0, -1, 0, static_cast<uint32_t>(count), order, parallelDepth);
+        }
+
+        // gather to the tree order
+        std::vector<Vec3d> treePoints(count);
+        ids.assign(count, UndefinedIndexT);
+        ParallelFor(0, count, [&](std::size_t i) {
+            treePoints[i] = points[order[i]];
+            ids[i] = srcIds[order[i]];
+        });
+        points = std::move(treePoints);
+        erased.assign(count, 0);
+        erasedCount = 0;
+
+        leafOf.assign(count, -1);
+        for (std::size_t n = 0; n < nodes.size(); ++n) {
+            if (nodes[n].left < 0) {
+                for (uint32_t i = nodes[n].begin; i < nodes[n].end; ++i) {
+                    leafOf[i] = static_cast<int32_t>(n);
+                }
+            }
+        }
+
+        slots.clear();
+        slots.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            slots.emplace(ids[i], i);
+        }
+        pendingPoints.clear();
+        pendingIds.clear();
+        pendingSlots.clear();
+    }
+
+    void LandmarkKdTree::BuildNode(int32_t idx, int32_t parent, uint32_t begin, uint32_t end,
+                                   std::vector<uint32_t> &order, std::size_t parallelDepth) {
+        Node &node = nodes[idx];
+        node.begin = begin;
+        node.end = end;
+        node.parent = parent;
+        node.box = AABB();
+        for (uint32_t i = begin; i < end; ++i) {
+            node.box.Extend(points[order[i]]);
+        }
+        if (end - begin <= leafSize) {
+            node.left = node.right = -1;
+            return;
+        }
+
+        // split at the median of the largest extent
+        int axis;
+        (node.box.max - node.box.min).maxCoeff(&axis);
+        const uint32_t mid = begin + (end - begin) / 2;
+        std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end,
+                         [this, axis](uint32_t a, uint32_t b) { return points[a](axis) < points[b](axis); });
+
+        node.left = idx + 1;
+        node.right = idx + 1 + static_cast<int32_t>(CountNodes(mid - begin, leafSize));
+        const int32_t left = node.left, right = node.right;
+        // small subtrees are not worth a thread
+        if (parallelDepth > 0 && end - begin > (1u << 14)) {
+            std::thread worker([&, left, idx, begin, mid, parallelDepth]() {
+                BuildNode(left, idx, begin, mid, order, parallelDepth - 1);
+            });
+            BuildNode(right, idx, mid, end, order, parallelDepth - 1);
+            worker.join();
+        } else {
+            BuildNode(left, idx, begin, mid, order, 0);
+            BuildNode(right, idx, mid, end, order, 0);
+        }
+    }
+
+    void LandmarkKdTree::Refit(const Landmarks &structure) {
+        // the positions are reloaded leaf by leaf in parallel, then the boxes are merged bottom-up
+        std::vector<int32_t> leaves;
+        for (std::size_t n = 0; n < nodes.size(); ++n) {
+            if (nodes[n].left < 0) {
+                leaves.push_back(static_cast<int32_t>(n));
+            }
+        }
+        ParallelFor(0, leaves.size(), [&](std::size_t l) {
+            Node &node = nodes[leaves[l]];
+            node.box = AABB();
+            for (uint32_t i = node.begin; i < node.end; ++i) {
+                if (erased[i]) {
+                    continue;
+                }
+                auto iter = structure.find(ids[i]);
+                if (iter != structure.cend()) {
+                    points[i] = iter->second.X;
+                }
+                node.box.Extend(points[i]);
+            }
+        }, 64);
+        // children are stored after their parent
+        for (auto n = static_cast<int32_t>(nodes.size()) - 1; n >= 0; --n) {
+            if (nodes[n].left >= 0) {
+                RefitNode(n);
+            }
+        }
+        for (std::size_t i = 0; i < pendingIds.size(); ++i) {
+            auto iter = structure.find(pendingIds[i]);
+            if (iter != structure.cend()) {
+                pendingPoints[i] = iter->second.X;
+            }
+        }
+    }
+
+    void LandmarkKdTree::RefitNode(int32_t idx) {
+        Node &node = nodes[idx];
+        node.box = nodes[node.left].box;
+        node.box.Extend(nodes[node.right].box);
+    }
+
+    bool LandmarkKdTree::Update(IndexT lmId, const Vec3d &X) {
+        if (auto iter = slots.find(lmId); iter != slots.end() && !erased[iter->second]) {
+            points[iter->second] = X;
+            for (int32_t n = leafOf[iter->second]; n >= 0 && !nodes[n].box.Contains(X); n = nodes[n].parent) {
+                nodes[n].box.Extend(X);
+            }
+            return true;
+        }
+        if (auto iter = pendingSlots.find(lmId); iter != pendingSlots.end()) {
+            pendingPoints[iter->second] = X;
+            return true;
+        }
+        return false;
+    }
+
+    void LandmarkKdTree::Insert(IndexT lmId, const Vec3d &X) {
+        if (Update(lmId, X)) {
+            return;
+        }
+        pendingSlots.emplace(lmId, pendingIds.size());
+        pendingIds.push_back(lmId);
+        pendingPoints.push_back(X);
+    }
+
+    bool LandmarkKdTree::Erase(IndexT lmId) {
+        if (auto iter = slots.find(lmId); iter != slots.end()) {
+            erased[iter->second] = 1;
+            ++erasedCount;
+            slots.erase(iter);
+            return true;
+        }
+        if (auto iter = pendingSlots.find(lmId); iter != pendingSlots.end()) {
+            // swap with the last pending landmark
+            const std::size_t slot = iter->second;
+            pendingSlots.erase(iter);
+            if (slot + 1 != pendingIds.size()) {
+                pendingIds[slot] = pendingIds.back();
+                pendingPoints[slot] = pendingPoints.back();
+                pendingSlots[pendingIds[slot]] = slot;
+            }
+            pendingIds.pop_back();
+            pendingPoints.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    bool LandmarkKdTree::NeedRebuild() const {
+        return 4 * (pendingIds.size() + erasedCount) > ids.size() + 64;
+    }
+
+    std::size_t LandmarkKdTree::Size() const {
+        return ids.size() - erasedCount + pendingIds.size();
+    }
+
+    std::vector<IndexT> LandmarkKdTree::RadiusSearch(const Vec3d &center, double radius) const {
+        const double r2 = radius * radius;
+        std::vector<IndexT> result;
+        Traverse(
+                [&](const AABB &box) {
+                    if (box.SquaredDistance(center) > r2) {
+                        return Frustum::OUTSIDE;
+                    }
+                    // the farthest corner is within the radius
+                    const Vec3d far = (box.min - center).cwiseAbs().cwiseMax((box.max - center).cwiseAbs());
+                    return far.squaredNorm() <= r2 ? Frustum::INSIDE : Frustum::INTERSECT;
+                },
+                [&](const Vec3d &p) { return (p - center).squaredNorm() <= r2; },
+                [&](IndexT lmId, const Vec3d &) { result.push_back(lmId); }
+        );
+        return result;
+    }
+
+    std::vector<LandmarkKdTree::Neighbor> LandmarkKdTree::KNearest(const Vec3d &center, std::size_t k) const {
+        std::vector<Neighbor> heap;
+        if (k == 0) {
+            return heap;
+        }
+        heap.reserve(k);
+        if (!nodes.empty()) {
+            KNearestNode(0, center, k, heap);
+        }
+        for (std::size_t i = 0; i < pendingIds.size(); ++i) {
+            PushNeighbor(heap, k, pendingIds[i], (pendingPoints[i] - center).squaredNorm());
+        }
+        std::sort_heap(heap.begin(), heap.end(), NeighborLess);
+        return heap;
+    }
+
+    void LandmarkKdTree::KNearestNode(int32_t idx, const Vec3d &center, std::size_t k,
+                                      std::vector<Neighbor> &heap) const {
+        const Node &node = nodes[idx];
+        if (heap.size() == k && node.box.SquaredDistance(center) >= heap.front().second) {
+            return;
+        }
+        if (node.left < 0) {
+            for (uint32_t i = node.begin; i < node.end; ++i) {
+                if (!erased[i]) {
+                    PushNeighbor(heap, k, ids[i], (points[i] - center).squaredNorm());
+                }
+            }
+            return;
+        }
+        // the nearer child first, to shrink the search radius early
+        int32_t first = node.left, second = node.right;
+        if (nodes[second].box.SquaredDistance(center) < nodes[first].box.SquaredDistance(center)) {
+            std::swap(first, second);
+        }
+        KNearestNode(first, center, k, heap);
+        KNearestNode(second, center, k, heap);
+    }
+
+    std::vector<IndexT> LandmarkKdTree::BoxSearch(const AABB &box) const {
+        std::vector<IndexT> result;
+        Traverse(
+                [&](const AABB &nodeBox) {
+                    if (!box.Intersects(nodeBox)) {
+                        return Frustum::OUTSIDE;
+                    }
+                    return box.Contains(nodeBox) ? Frustum::INSIDE : Frustum::INTERSECT;
+                },
+                [&](const Vec3d &p) { return box.Contains(p); },
+                [&](IndexT lmId, const Vec3d &) { result.push_back(lmId); }
+        );
+        return result;
+    }
+
+    std::vector<IndexT> LandmarkKdTree::FrustumSearch(const Frustum &frustum) const {
+        std::vector<IndexT> result;
+        Traverse(
+                [&](const AABB &nodeBox) { return frustum.Classify(nodeBox); },
+                [&](const Vec3d &p) { return frustum.Contains(p); },
+                [&](IndexT lmId, const Vec3d &) { result.push_back(lmId); }
+        );
+        return result;
+    }
+}
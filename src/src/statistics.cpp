@@ -0,0 +1,271 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/statistics.h"
+#include "view_slots.h"
+
+namespace ns_veta {
+
+    // ------------
+    // accumulators
+    // ------------
+
+    void RunningStats::Add(double value) {
+        ++count;
+        sum += value;
+        sumSq += value * value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    void RunningStats::Merge(const RunningStats &other) {
+        count += other.count;
+        sum += other.sum;
+        sumSq += other.sumSq;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    double RunningStats::Mean() const {
+        return count ? sum / static_cast<double>(count) : 0.0;
+    }
+
+    double RunningStats::StdDev() const {
+        if (count < 2) {
+            return 0.0;
+        }
+        const double mean = Mean();
+        return std::sqrt(std::max(0.0, sumSq / static_cast<double>(count) - mean * mean));
+    }
+
+    Histogram::Histogram(double binWidth, std::size_t bins) : binWidth(binWidth), counts(bins, 0) {}
+
+    void Histogram::Add(double value) {
+        if (counts.empty()) {
+            return;
+        }
+        const double bin = std::floor(std::max(value, 0.0) / binWidth);
+        const std::size_t last = counts.size() - 1;
+        ++counts[bin < static_cast<double>(last) ? static_cast<std::size_t>(bin) : last];
+    }
+
+    void Histogram::Merge(const Histogram &other) {
+        if (counts.size() < other.counts.size()) {
+            counts.resize(other.counts.size(), 0);
+        }
+        for (std::size_t i = 0; i < other.counts.size(); ++i) {
+            counts[i] += other.counts[i];
+        }
+    }
+
+    void ReprojectionStats::Add(double error) {
+        ++count;
+        sumSq += error * error;
+        max = std::max(max, error);
+    }
+
+    void ReprojectionStats::Merge(const ReprojectionStats &other) {
+        count += other.count;
+        sumSq += other.sumSq;
+        max = std::max(max, other.max);
+    }
+
+    double ReprojectionStats::RMSE() const {
+        return count ? std::sqrt(sumSq / static_cast<double>(count)) : 0.0;
+    }
+
+    std::ostream &operator<<(std::ostream &os, const SceneStatistics &stats) {
+        os << "views: " << stats.views << ", poses: " << stats.poses << ", intrinsics: " << stats.intrinsics
+           << ", landmarks: " << stats.landmarks << ", observations: " << stats.observations << '\n';
+        os << "track length: mean " << stats.trackLengthStats.Mean() << ", std " << stats.trackLengthStats.StdDev()
+           << ", max " << (stats.trackLengthStats.count ? stats.trackLengthStats.max : 0.0) << '\n';
+        for (const auto &[intrinsicId, reproj]: stats.reprojection) {
+            os << "intrinsic " << intrinsicId << ": observations " << reproj.count << ", rmse " << reproj.RMSE()
+               << " px, max " << reproj.max << " px\n";
+        }
+        os << "bbox: [" << stats.bboxMin.transpose() << "] - [" << stats.bboxMax.transpose() << "], density: "
+           << stats.density << '\n';
+        os << "triangulation angle: mean " << stats.triangulationAngleStats.Mean() << " deg, std "
+           << stats.triangulationAngleStats.StdDev() << " deg, baseline: mean " << stats.baselineStats.Mean()
+           << ", max " << (stats.baselineStats.count ? stats.baselineStats.max : 0.0);
+        return os;
+    }
+
+    namespace {
+        // observations waiting to be reprojected by an intrinsic
+        struct ReprojectionBuffer {
+        public:
+            Mat3Xd Xc;
+            Mat2Xd x;
+            Eigen::Index size = 0;
+        };
+
+        constexpr Eigen::Index ReprojectionBatch = 4096;
+
+        // the statistics gathered by a worker
+        struct Accumulator {
+        public:
+            Histogram trackLength, angle, baseline;
+            RunningStats trackLengthStats, angleStats, baselineStats;
+            std::vector<std::size_t> obsPerSlot;
+            std::vector<ReprojectionStats> reprojection;
+            std::vector<ReprojectionBuffer> buffers;
+            Vec3d bboxMin = Vec3d::Constant(std::numeric_limits<double>::max());
+            Vec3d bboxMax = Vec3d::Constant(std::numeric_limits<double>::lowest());
+            std::size_t observations = 0;
+
+            void Flush(const IntrinsicBase &intrinsic, std::size_t g, bool ignoreDisto) {
+                ReprojectionBuffer &buffer = buffers[g];
+                if (buffer.size == 0) {
+                    return;
+                }
+                const auto Xc = buffer.Xc.leftCols(buffer.size);
+                const auto x = buffer.x.leftCols(buffer.size);
+                const Mat2Xd residuals = intrinsic.Residuals(Xc, x, ignoreDisto);
+                // the points behind the camera (against the bearings of their observations) are not reprojected
+                // errors, as in the resection
+                const Mat3Xd bearings = intrinsic(x);
+                for (Eigen::Index j = 0; j < residuals.cols(); ++j) {
+                    if (Xc.col(j).dot(bearings.col(j)) > 0.0) {
+                        reprojection[g].Add(residuals.col(j).norm());
+                    }
+                }
+                buffer.size = 0;
+            }
+        };
+    }
+
+    SceneStatistics ComputeStatistics(const Veta &veta, const StatisticsOptions &options) {
+        SceneStatistics stats;
+        stats.views = veta.views.size();
+        stats.poses = veta.poses.size();
+        stats.intrinsics = veta.intrinsics.size();
+        stats.landmarks = veta.structure.size();
+        stats.trackLength = Histogram(1.0, options.maxTrackLength + 1);
+        stats.triangulationAngle = Histogram(options.angleBinWidth, options.angleBins);
+        stats.baseline = Histogram(options.baselineBinWidth, options.baselineBins);
+
+        const ViewSlots viewSlots = ViewSlots::Build(veta, false);
+        const std::vector<ViewSlot> &slots = viewSlots.slots;
+        const HashMap<IndexT, uint32_t> &slotOfView = viewSlots.slotOfView;
+        const std::vector<const IntrinsicBase *> &intrinsics = viewSlots.intrinsics;
+
+        std::vector<const Landmark *> landmarks;
+        landmarks.reserve(veta.structure.size());
+        for (const auto &[lmId, lm]: veta.structure) {
+            landmarks.push_back(&lm);
+        }
+
+        std::vector<Accumulator> accumulators(HardwareThreads());
+        const bool reproject = options.reprojection && !intrinsics.empty();
+        const std::size_t workers = ParallelForRange(0, landmarks.size(), [&](std::size_t lo, std::size_t hi,
+                                                                              std::size_t w) {
+            Accumulator &acc = accumulators[w];
+            acc.trackLength = stats.trackLength;
+            acc.angle = stats.triangulationAngle;
+            acc.baseline = stats.baseline;
+            acc.obsPerSlot.assign(slots.size(), 0);
+            acc.reprojection.assign(intrinsics.size(), ReprojectionStats());
+            acc.buffers.resize(intrinsics.size());
+            if (reproject) {
+                for (auto &buffer: acc.buffers) {
+                    buffer.Xc.resize(3, ReprojectionBatch);
+                    buffer.x.resize(2, ReprojectionBatch);
+                }
+            }
+            // the centers of the posed views of a track, and the rays to the landmark
+            std::vector<Vec3d> centers, rays;
+            for (std::size_t i = lo; i < hi; ++i) {
+                const Landmark &lm = *landmarks[i];
+                const auto length = static_cast<double>(lm.obs.size());
+                acc.trackLength.Add(length);
+                acc.trackLengthStats.Add(length);
+                acc.observations += lm.obs.size();
+                acc.bboxMin = acc.bboxMin.cwiseMin(lm.X);
+                acc.bboxMax = acc.bboxMax.cwiseMax(lm.X);
+
+                centers.clear();
+                rays.clear();
+                for (const auto &[viewId, obs]: lm.obs) {
+                    auto iter = slotOfView.find(viewId);
+                    if (iter == slotOfView.cend()) {
+                        continue;
+                    }
+                    ++acc.obsPerSlot[iter->second];
+                    const ViewSlot &slot = slots[iter->second];
+                    if (!slot.posed) {
+                        continue;
+                    }
+                    const Vec3d ray = lm.X - slot.C;
+                    const double norm = ray.norm();
+                    if (norm > 0.0) {
+                        centers.push_back(slot.C);
+                        rays.push_back(ray / norm);
+                    }
+                    if (reproject && slot.hasIntrinsic) {
+                        ReprojectionBuffer &buffer = acc.buffers[slot.intrinsic];
+                        buffer.Xc.col(buffer.size) = slot.R * lm.X + slot.t;
+                        buffer.x.col(buffer.size) = obs.x.cast<double>();
+                        if (++buffer.size == ReprojectionBatch) {
+                            acc.Flush(*intrinsics[slot.intrinsic], slot.intrinsic, options.ignoreDisto);
+                        }
+                    }
+                }
+
+                if (rays.size() >= 2) {
+                    const double angle = MaxRayAngle(rays), baseline = MaxDistance(centers);
+                    acc.angle.Add(angle);
+                    acc.angleStats.Add(angle);
+                    acc.baseline.Add(baseline);
+                    acc.baselineStats.Add(baseline);
+                }
+            }
+            if (reproject) {
+                for (std::size_t g = 0; g < intrinsics.size(); ++g) {
+                    acc.Flush(*intrinsics[g], g, options.ignoreDisto);
+                }
+            }
+        }, 1024, accumulators.size());
+
+        // merge the accumulators of the workers
+        std::vector<std::size_t> obsPerSlot(slots.size(), 0);
+        std::vector<ReprojectionStats> reprojection(intrinsics.size());
+        Vec3d bboxMin = Vec3d::Constant(std::numeric_limits<double>::max());
+        Vec3d bboxMax = Vec3d::Constant(std::numeric_limits<double>::lowest());
+        for (std::size_t w = 0; w < workers; ++w) {
+            const Accumulator &acc = accumulators[w];
+            stats.observations += acc.observations;
+            stats.trackLength.Merge(acc.trackLength);
+            stats.trackLengthStats.Merge(acc.trackLengthStats);
+            stats.triangulationAngle.Merge(acc.angle);
+            stats.triangulationAngleStats.Merge(acc.angleStats);
+            stats.baseline.Merge(acc.baseline);
+            stats.baselineStats.Merge(acc.baselineStats);
+            for (std::size_t s = 0; s < slots.size(); ++s) {
+                obsPerSlot[s] += acc.obsPerSlot[s];
+            }
+            for (std::size_t g = 0; g < intrinsics.size(); ++g) {
+                reprojection[g].Merge(acc.reprojection[g]);
+            }
+            bboxMin = bboxMin.cwiseMin(acc.bboxMin);
+            bboxMax = bboxMax.cwiseMax(acc.bboxMax);
+        }
+
+        for (std::size_t s = 0; s < slots.size(); ++s) {
+            stats.observationsPerView.emplace_hint(stats.observationsPerView.end(), slots[s].viewId, obsPerSlot[s]);
+        }
+        if (reproject) {
+            for (std::size_t g = 0; g < intrinsics.size(); ++g) {
+                stats.reprojection.insert({viewSlots.intrinsicIds[g], reprojection[g]});
+            }
+        }
+        if (!landmarks.empty()) {
+            stats.bboxMin = bboxMin;
+            stats.bboxMax = bboxMax;
+            const double volume = (bboxMax - bboxMin).prod();
+            stats.density = volume > 0.0 ? static_cast<double>(landmarks.size()) / volume : 0.0;
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,184 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/structure_builder.h"
+#include <queue>
+
+namespace ns_veta {
+
+    // ------
+    // Writer
+    // ------
+
+    StructureBuilder::Writer::Writer(StructureBuilder *builder, Staging *staging)
+            : builder(builder), staging(staging) {}
+
+    void StructureBuilder::Writer::AddLandmark(IndexT lmId, Landmark lm) {
+        staging->landmarks.emplace_back(lmId, std::move(lm));
+    }
+
+    void StructureBuilder::Writer::AddObservation(IndexT lmId, IndexT viewId, const Observation &obs) {
+        staging->observations.push_back({lmId, viewId, obs});
+    }
+
+    IndexT StructureBuilder::Writer::NewLandmarkId() {
+        return builder->NewLandmarkId();
+    }
+
+    // ----------------
+    // StructureBuilder
+    // ----------------
+
+    StructureBuilder::StructureBuilder(IndexT firstLandmarkId) : nextLandmarkId(firstLandmarkId) {}
+
+    StructureBuilder::Ptr StructureBuilder::Create(IndexT firstLandmarkId) {
+        return std::make_shared<StructureBuilder>(firstLandmarkId);
+    }
+
+    StructureBuilder::Writer StructureBuilder::MakeWriter() {
+        std::lock_guard<std::mutex> lock(mutex);
+        stagings.emplace_back();
+        return {this, &stagings.back()};
+    }
+
+    IndexT StructureBuilder::NewLandmarkId() {
+        return nextLandmarkId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::pair<std::size_t, std::size_t> StructureBuilder::StagedCount() const {
+        std::size_t lms = 0, obs = 0;
+        for (const Staging &staging: stagings) {
+            lms += staging.landmarks.size();
+            obs += staging.observations.size();
+        }
+        return {lms, obs};
+    }
+
+    std::size_t StructureBuilder::Merge(Landmarks &structure) {
+        std::vector<Staging *> writers;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (Staging &staging: stagings) {
+                writers.push_back(&staging);
+            }
+        }
+        const auto [lmCount, obsCount] = StagedCount();
+        if (lmCount == 0 && obsCount == 0) {
+            return 0;
+        }
+
+        // the staged items are dispatched to shards by landmark id, so that the shards are independent
+        const std::size_t shards = std::min<std::size_t>(
+                HardwareThreads(), std::max<std::size_t>(1, (lmCount + obsCount) / 4096)
+        );
+        auto ShardOf = [shards](IndexT lmId) {
+            return std::hash<IndexT>()(lmId) % shards;
+        };
+        std::vector<std::vector<std::vector<std::pair<IndexT, Landmark> *>>> lmBuckets(
+                writers.size(), std::vector<std::vector<std::pair<IndexT, Landmark> *>>(shards)
+        );
+        std::vector<std::vector<std::vector<const StagedObservation *>>> obsBuckets(
+                writers.size(), std::vector<std::vector<const StagedObservation *>>(shards)
+        );
+        ParallelFor(0, writers.size(), [&](std::size_t w) {
+            for (auto &item: writers[w]->landmarks) {
+                lmBuckets[w][ShardOf(item.first)].push_back(&item);
+            }
+            for (const auto &item: writers[w]->observations) {
+                obsBuckets[w][ShardOf(item.lmId)].push_back(&item);
+            }
+        }, 1);
+
+        // each shard merges its landmarks, the structure is only modified at landmarks of the shard
+        std::vector<std::vector<std::pair<IndexT, Landmark>>> added(shards);
+        ParallelFor(0, shards, [&](std::size_t s) {
+            std::vector<std::pair<IndexT, Landmark> *> lms;
+            std::vector<const StagedObservation *> observations;
+            for (std::size_t w = 0; w < writers.size(); ++w) {
+                lms.insert(lms.end(), lmBuckets[w][s].cbegin(), lmBuckets[w][s].cend());
+                observations.insert(observations.end(), obsBuckets[w][s].cbegin(), obsBuckets[w][s].cend());
+            }
+            std::stable_sort(lms.begin(), lms.end(), [](const auto *a, const auto *b) {
+                return a->first < b->first;
+            });
+            std::stable_sort(observations.begin(), observations.end(), [](const auto *a, const auto *b) {
+                return a->lmId < b->lmId;
+            });
+
+            // the landmarks staged several times are merged into the first one
+            std::vector<std::pair<IndexT, Landmark>> merged;
+            merged.reserve(lms.size());
+            for (auto *item: lms) {
+                if (!merged.empty() && merged.back().first == item->first) {
+                    merged.back().second.obs.insert(item->second.obs.cbegin(), item->second.obs.cend());
+                } else {
+                    merged.push_back(std::move(*item));
+                }
+            }
+
+            // both sorted by landmark id
+            auto lmIter = merged.begin();
+            for (const StagedObservation *item: observations) {
+                while (lmIter != merged.end() && lmIter->first < item->lmId) {
+                    ++lmIter;
+                }
+                if (lmIter != merged.end() && lmIter->first == item->lmId) {
+                    lmIter->second.obs[item->viewId] = item->obs;
+                    continue;
+                }
+                // concurrent lookups, the structure is not modified before the last insertion step
+                auto iter = structure.find(item->lmId);
+                if (iter != structure.end()) {
+                    iter->second.obs[item->viewId] = item->obs;
+                }
+            }
+
+            for (auto &[lmId, lm]: merged) {
+                auto iter = structure.find(lmId);
+                if (iter == structure.end()) {
+                    added[s].emplace_back(lmId, std::move(lm));
+                    continue;
+                }
+                Landmark &target = iter->second;
+                target.X = lm.X;
+                target.color = lm.color;
+                for (const auto &[viewId, obs]: lm.obs) {
+                    target.obs[viewId] = obs;
+                }
+            }
+        }, 1);
+
+        // the new landmarks are inserted by increasing ids (k-way merge of the shards), each hint is the position
+        // after the previous insertion
+        using Head = std::pair<IndexT, std::size_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+        std::vector<std::size_t> cursors(shards, 0);
+        std::size_t count = 0;
+        for (std::size_t s = 0; s < shards; ++s) {
+            if (!added[s].empty()) {
+                heads.emplace(added[s].front().first, s);
+            }
+            count += added[s].size();
+        }
+        auto hint = structure.end();
+        if (!heads.empty()) {
+            hint = structure.lower_bound(heads.top().first);
+        }
+        while (!heads.empty()) {
+            const std::size_t s = heads.top().second;
+            heads.pop();
+            auto &item = added[s][cursors[s]++];
+            hint = std::next(structure.emplace_hint(hint, item.first, std::move(item.second)));
+            if (cursors[s] < added[s].size()) {
+                heads.emplace(added[s][cursors[s]].first, s);
+            }
+        }
+
+        for (Staging *staging: writers) {
+            staging->landmarks.clear();
+            staging->observations.clear();
+        }
+        return count;
+    }
+}
@@ -0,0 +1,123 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/sub_scene.h"
+
+namespace ns_veta {
+
+    ViewLandmarks BuildViewLandmarks(const Landmarks &structure) {
+        ViewLandmarks index;
+        // landmarks are visited by increasing id, so that the lists are sorted
+        for (const auto &[lmId, lm]: structure) {
+            for (const auto &[viewId, obs]: lm.obs) {
+                index[viewId].push_back(lmId);
+            }
+        }
+        return index;
+    }
+
+    // -----------
+    // SubSceneRef
+    // -----------
+
+    SubSceneRef::SubSceneRef(const Veta &parent, const std::set<IndexT> &viewIds, const ViewLandmarks &index,
+                             std::size_t minObservations) : parent(&parent) {
+        for (const IndexT viewId: viewIds) {
+            if (parent.views.count(viewId) != 0) {
+                this->viewIds.insert(this->viewIds.end(), viewId);
+            }
+        }
+        minObservations = std::max<std::size_t>(minObservations, 1);
+
+        // a landmark appears once in the list of each view observing it
+        std::vector<IndexT> observed;
+        for (const IndexT viewId: this->viewIds) {
+            auto iter = index.find(viewId);
+            if (iter != index.cend()) {
+                observed.insert(observed.end(), iter->second.cbegin(), iter->second.cend());
+            }
+        }
+        std::sort(observed.begin(), observed.end());
+        for (std::size_t i = 0; i < observed.size();) {
+            std::size_t j = i + 1;
+            while (j < observed.size() && observed[j] == observed[i]) {
+                ++j;
+            }
+            if (j - i >= minObservations) {
+                landmarkIds.push_back(observed[i]);
+            }
+            i = j;
+        }
+    }
+
+    SubSceneRef::Ptr SubSceneRef::Create(const Veta &parent, const std::set<IndexT> &viewIds,
+                                         const ViewLandmarks &index, std::size_t minObservations) {
+        return std::make_shared<SubSceneRef>(parent, viewIds, index, minObservations);
+    }
+
+    const Veta &SubSceneRef::Parent() const {
+        return *parent;
+    }
+
+    const std::set<IndexT> &SubSceneRef::ViewIds() const {
+        return viewIds;
+    }
+
+    const std::vector<IndexT> &SubSceneRef::LandmarkIds() const {
+        return landmarkIds;
+    }
+
+    std::vector<IndexT> SubSceneRef::PoseIds() const {
+        std::set<IndexT> ids;
+        for (const IndexT viewId: viewIds) {
+            const auto &view = parent->views.at(viewId);
+            if (view && parent->poses.count(view->poseId) != 0) {
+                ids.insert(view->poseId);
+            }
+        }
+        return {ids.cbegin(), ids.cend()};
+    }
+
+    std::vector<IndexT> SubSceneRef::IntrinsicIds() const {
+        std::set<IndexT> ids;
+        for (const IndexT viewId: viewIds) {
+            const auto &view = parent->views.at(viewId);
+            if (view && parent->intrinsics.count(view->intrinsicId) != 0) {
+                ids.insert(view->intrinsicId);
+            }
+        }
+        return {ids.cbegin(), ids.cend()};
+    }
+
+    Veta SubSceneRef::Materialize() const {
+        Veta result;
+        for (const IndexT viewId: viewIds) {
+            result.views.emplace_hint(result.views.end(), viewId, parent->views.at(viewId));
+        }
+        for (const IndexT poseId: PoseIds()) {
+            result.poses.emplace_hint(result.poses.end(), poseId, parent->poses.at(poseId));
+        }
+        for (const IndexT intrinsicId: IntrinsicIds()) {
+            result.intrinsics.emplace_hint(result.intrinsics.end(), intrinsicId, parent->intrinsics.at(intrinsicId));
+        }
+        // ids are sorted, so that each insertion is amortized constant
+        for (const IndexT lmId: landmarkIds) {
+            const Landmark &lm = parent->structure.at(lmId);
+            Landmark &subLm = result.structure.emplace_hint(result.structure.end(), lmId, Landmark())->second;
+            subLm.X = lm.X;
+            subLm.color = lm.color;
+            for (const auto &[viewId, obs]: lm.obs) {
+                if (viewIds.count(viewId) != 0) {
+                    subLm.obs.emplace_hint(subLm.obs.end(), viewId, obs);
+                }
+            }
+        }
+        return result;
+    }
+
+    Veta ExtractSubScene(const Veta &veta, const std::set<IndexT> &viewIds, const ViewLandmarks &index,
+                         std::size_t minObservations) {
+        return SubSceneRef(veta, viewIds, index, minObservations).Materialize();
+    }
+}
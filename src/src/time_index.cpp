@@ -0,0 +1,215 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/time_index.h"
+
+namespace ns_veta {
+
+    // -------------
+    // ViewTimeIndex
+    // -------------
+
+    ViewTimeIndex::ViewTimeIndex(const Views &views) {
+        Build(views);
+    }
+
+    ViewTimeIndex::Ptr ViewTimeIndex::Create(const Views &views) {
+        return std::make_shared<ViewTimeIndex>(views);
+    }
+
+    void ViewTimeIndex::Build(const Views &views) {
+        std::vector<std::pair<TimeT, IndexT>> entries;
+        entries.reserve(views.size());
+        for (const auto &[viewId, view]: views) {
+            if (view && view->timestamp != UndefinedTimeT) {
+                entries.emplace_back(view->timestamp, viewId);
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+        times.resize(entries.size());
+        viewIds.resize(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            times[i] = entries[i].first;
+            viewIds[i] = entries[i].second;
+        }
+    }
+
+    std::size_t ViewTimeIndex::Size() const {
+        return times.size();
+    }
+
+    const std::vector<TimeT> &ViewTimeIndex::Times() const {
+        return times;
+    }
+
+    const std::vector<IndexT> &ViewTimeIndex::ViewIds() const {
+        return viewIds;
+    }
+
+    std::vector<IndexT> ViewTimeIndex::InRange(TimeT t0, TimeT t1) const {
+        const auto lower = std::lower_bound(times.cbegin(), times.cend(), t0);
+        const auto upper = std::upper_bound(lower, times.cend(), t1);
+        return {viewIds.cbegin() + (lower - times.cbegin()), viewIds.cbegin() + (upper - times.cbegin())};
+    }
+
+    IndexT ViewTimeIndex::Nearest(TimeT t) const {
+        if (times.empty()) {
+            return UndefinedIndexT;
+        }
+        const auto iter = std::lower_bound(times.cbegin(), times.cend(), t);
+        std::size_t i = iter - times.cbegin();
+        if (i == times.size() || (i > 0 && t - times[i - 1] <= times[i] - t)) {
+            --i;
+        }
+        return viewIds[i];
+    }
+
+    // ----------------
+    // PoseInterpolator
+    // ----------------
+
+    PoseInterpolator::PoseInterpolator(std::vector<std::pair<TimeT, Posed>> keyPoses, Mode mode) : mode(mode) {
+        std::stable_sort(keyPoses.begin(), keyPoses.end(),
+                         [](const auto &a, const auto &b) { return a.first < b.first; });
+        for (auto &[t, pose]: keyPoses) {
+            if (times.empty() || times.back() != t) {
+                times.push_back(t);
+                poses.push_back(std::move(pose));
+            }
+        }
+        Prepare();
+    }
+
+    PoseInterpolator::PoseInterpolator(const Veta &veta, Mode mode) : mode(mode) {
+        std::vector<std::pair<TimeT, Posed>> keyPoses;
+        for (const auto &[viewId, view]: veta.views) {
+            if (!view || view->timestamp == UndefinedTimeT) {
+                continue;
+            }
+            auto iter = veta.poses.find(view->poseId);
+            if (iter != veta.poses.cend()) {
+                keyPoses.emplace_back(view->timestamp, iter->second);
+            }
+        }
+        *this = PoseInterpolator(std::move(keyPoses), mode);
+    }
+
+    PoseInterpolator::Ptr PoseInterpolator::Create(const Veta &veta, Mode mode) {
+        return std::make_shared<PoseInterpolator>(veta, mode);
+    }
+
+    PoseInterpolator::Mode PoseInterpolator::GetMode() const {
+        return mode;
+    }
+
+    std::size_t PoseInterpolator::Size() const {
+        return times.size();
+    }
+
+    std::pair<TimeT, TimeT> PoseInterpolator::TimeRange() const {
+        if (times.empty()) {
+            return {UndefinedTimeT, UndefinedTimeT};
+        }
+        return {times.front(), times.back()};
+    }
+
+    void PoseInterpolator::Prepare() {
+        quats.clear();
+        squadCtrl.clear();
+        if (mode != CUBIC_SPLINE) {
+            return;
+        }
+        // keep the quaternions on the same hemisphere
+        quats.reserve(poses.size());
+        for (const auto &pose: poses) {
+            Quaterniond q = pose.Rotation().unit_quaternion();
+            if (!quats.empty() && quats.back().dot(q) < 0.0) {
+                q.coeffs() = -q.coeffs();
+            }
+            quats.push_back(q);
+        }
+        // s_i = q_i * exp(-(log(q_i^-1 * q_i+1) + log(q_i^-1 * q_i-1)) / 4)
+        squadCtrl = quats;
+        for (std::size_t i = 1; i + 1 < quats.size(); ++i) {
+            const Quaterniond inv = quats[i].conjugate();
+            const Vec3d next = Sophus::SO3d(inv * quats[i + 1]).log();
+            const Vec3d prev = Sophus::SO3d(inv * quats[i - 1]).log();
+            squadCtrl[i] = quats[i] * Sophus::SO3d::exp(-0.25 * (next + prev)).unit_quaternion();
+        }
+    }
+
+    Posed PoseInterpolator::Interpolate(std::size_t i, TimeT t) const {
+        const TimeT t0 = times[i], t1 = times[i + 1];
+        const double a = (t - t0) / (t1 - t0);
+        const Posed &p0 = poses[i], &p1 = poses[i + 1];
+        switch (mode) {
+            case SLERP: {
+                const Quaterniond q = p0.Rotation().unit_quaternion().slerp(a, p1.Rotation().unit_quaternion());
+                return Posed(Sophus::SO3d(q), (1.0 - a) * p0.Translation() + a * p1.Translation());
+            }
+            case SE3_GEODESIC: {
+                const Sophus::SE3d T0(p0.Rotation(), p0.Translation()), T1(p1.Rotation(), p1.Translation());
+                const Sophus::SE3d T = T0 * Sophus::SE3d::exp(a * (T0.inverse() * T1).log());
+                return Posed(T.so3(), T.translation());
+            }
+            case CUBIC_SPLINE: {
+                // finite difference tangents (per unit time), one-sided at both ends
+                auto tangent = [this](std::size_t k) -> Vec3d {
+                    const std::size_t lo = k == 0 ? 0 : k - 1, hi = std::min(k + 1, times.size() - 1);
+                    return (poses[hi].Translation() - poses[lo].Translation()) / (times[hi] - times[lo]);
+                };
+                const double h = t1 - t0, a2 = a * a, a3 = a2 * a;
+                const Vec3d trans = (2 * a3 - 3 * a2 + 1) * p0.Translation() + (a3 - 2 * a2 + a) * h * tangent(i) +
+                                    (-2 * a3 + 3 * a2) * p1.Translation() + (a3 - a2) * h * tangent(i + 1);
+                const Quaterniond q = quats[i].slerp(a, quats[i + 1]).slerp(
+                        2 * a * (1 - a), squadCtrl[i].slerp(a, squadCtrl[i + 1])
+                );
+                return Posed(Sophus::SO3d(q.normalized()), trans);
+            }
+        }
+        return p0;
+    }
+
+    bool PoseInterpolator::PoseAt(TimeT t, Posed &pose) const {
+        if (times.empty() || t < times.front() || t > times.back()) {
+            return false;
+        }
+        if (times.size() == 1) {
+            pose = poses.front();
+            return true;
+        }
+        // the segment [times[i], times[i + 1]] holding 't'
+        std::size_t i = std::upper_bound(times.cbegin(), times.cend(), t) - times.cbegin();
+        i = std::min(i, times.size() - 1) - 1;
+        pose = Interpolate(i, t);
+        return true;
+    }
+
+    std::vector<uint8_t> PoseInterpolator::PosesAt(const std::vector<TimeT> &sortedTimes,
+                                                   std::vector<Posed> &result) const {
+        std::vector<uint8_t> valid(sortedTimes.size(), 0);
+        result.assign(sortedTimes.size(), Posed());
+        if (times.empty()) {
+            return valid;
+        }
+        // both sequences are sorted: walk the segments along with the queries
+        std::size_t i = 0;
+        for (std::size_t j = 0; j < sortedTimes.size(); ++j) {
+            const TimeT t = sortedTimes[j];
+            if (t < times.front() || t > times.back()) {
+                continue;
+            }
+            if (times.size() == 1) {
+                result[j] = poses.front();
+            } else {
+                while (i + 2 < times.size() && times[i + 1] < t) {
+                    ++i;
+                }
+                result[j] = Interpolate(i, t);
+            }
+            valid[j] = 1;
+        }
+        return valid;
+    }
+}
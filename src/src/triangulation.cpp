@@ -0,0 +1,289 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/triangulation.h"
+#include "view_slots.h"
+#include <eigen3/Eigen/Eigenvalues>
+
+namespace ns_veta {
+
+    namespace {
+        Mat3d Skew(const Vec3d &v) {
+            Mat3d m;
+            m << 0.0, -v(2), v(1), v(2), 0.0, -v(0), -v(1), v(0), 0.0;
+            return m;
+        }
+
+        // the observations of a track: views and bearings (in the camera frames)
+        struct TrackView {
+        public:
+            const std::vector<ViewSlot> &slots;
+            const uint32_t *slotIds;
+            const Mat3Xd &bearings;
+            Eigen::Index first;
+            std::size_t count;
+
+            [[nodiscard]] const ViewSlot &Slot(std::size_t j) const {
+                return slots[slotIds[j]];
+            }
+
+            [[nodiscard]] Vec3d Bearing(std::size_t j) const {
+                return bearings.col(first + static_cast<Eigen::Index>(j));
+            }
+        };
+
+        bool SolveDLT(const TrackView &track, Vec3d &X) {
+            // coordinates centered on the camera centers and scaled by their spread
+            Vec3d c = Vec3d::Zero();
+            for (std::size_t j = 0; j < track.count; ++j) {
+                c += track.Slot(j).C;
+            }
+            c /= static_cast<double>(track.count);
+            double s = 0.0;
+            for (std::size_t j = 0; j < track.count; ++j) {
+                s += (track.Slot(j).C - c).norm();
+            }
+            s = s > 0.0 ? s / static_cast<double>(track.count) : 1.0;
+
+            Mat4d AtA = Mat4d::Zero();
+            for (std::size_t j = 0; j < track.count; ++j) {
+                const ViewSlot &slot = track.Slot(j);
+                Mat34d P;
+                P << slot.R, (slot.R * c + slot.t) / s;
+                const Eigen::Matrix<double, 3, 4> A = Skew(track.Bearing(j)) * P;
+                AtA.noalias() += A.transpose() * A;
+            }
+            const Eigen::SelfAdjointEigenSolver<Mat4d> solver(AtA);
+            const Vec4d v = solver.eigenvectors().col(0);
+            if (std::abs(v(3)) < 1E-12 * v.head<3>().norm()) {
+                // at infinity
+                return false;
+            }
+            X = c + s * v.head<3>() / v(3);
+            return X.allFinite();
+        }
+
+        bool SolveMidpoint(const TrackView &track, Vec3d &X) {
+            Mat3d H = Mat3d::Zero();
+            Vec3d g = Vec3d::Zero();
+            for (std::size_t j = 0; j < track.count; ++j) {
+                const ViewSlot &slot = track.Slot(j);
+                const Vec3d d = slot.R.transpose() * track.Bearing(j);
+                const Mat3d proj = Mat3d::Identity() - d * d.transpose();
+                H += proj;
+                g += proj * slot.C;
+            }
+            // parallel rays: the matrix is singular
+            if (H.determinant() < 1E-12 * static_cast<double>(track.count * track.count * track.count)) {
+                return false;
+            }
+            X = H.ldlt().solve(g);
+            return X.allFinite();
+        }
+
+        // sum of the squared differences between the bearings and the normalized points in the camera frames
+        double BearingCost(const TrackView &track, const Vec3d &X) {
+            double cost = 0.0;
+            for (std::size_t j = 0; j < track.count; ++j) {
+                const ViewSlot &slot = track.Slot(j);
+                cost += ((slot.R * X + slot.t).normalized() - track.Bearing(j)).squaredNorm();
+            }
+            return cost;
+        }
+
+        void Refine(const TrackView &track, Vec3d &X, int iterations) {
+            double cost = BearingCost(track, X);
+            for (int iter = 0; iter < iterations; ++iter) {
+                Mat3d H = Mat3d::Zero();
+                Vec3d g = Vec3d::Zero();
+                for (std::size_t j = 0; j < track.count; ++j) {
+                    const ViewSlot &slot = track.Slot(j);
+                    const Vec3d y = slot.R * X + slot.t;
+                    const double norm = y.norm();
+                    const Vec3d u = y / norm;
+                    const Mat3d J = (Mat3d::Identity() - u * u.transpose()) / norm * slot.R;
+                    H.noalias() += J.transpose() * J;
+                    g.noalias() += J.transpose() * (u - track.Bearing(j));
+                }
+                const Vec3d dX = -H.ldlt().solve(g);
+                const Vec3d newX = X + dX;
+                const double newCost = BearingCost(track, newX);
+                if (!newX.allFinite() || !(newCost < cost)) {
+                    break;
+                }
+                X = newX;
+                cost = newCost;
+            }
+        }
+
+        bool InFront(const TrackView &track, const Vec3d &X) {
+            for (std::size_t j = 0; j < track.count; ++j) {
+                const ViewSlot &slot = track.Slot(j);
+                if ((slot.R * X + slot.t).dot(track.Bearing(j)) <= 0.0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // maximum angle (degrees) between two rays
+        double MaxAngle(const TrackView &track) {
+            std::vector<Vec3d> rays(track.count);
+            for (std::size_t j = 0; j < track.count; ++j) {
+                rays[j] = track.Slot(j).R.transpose() * track.Bearing(j);
+            }
+            return MaxRayAngle(rays);
+        }
+    }
+
+    TriangulationReport Triangulate(Veta &veta, const TriangulationOptions &options) {
+        // views with a pose and an intrinsic
+        const ViewSlots viewSlots = ViewSlots::Build(veta, true);
+        const std::vector<ViewSlot> &slots = viewSlots.slots;
+        const HashMap<IndexT, uint32_t> &slotOfView = viewSlots.slotOfView;
+        const std::vector<const IntrinsicBase *> &intrinsics = viewSlots.intrinsics;
+
+        std::vector<std::pair<IndexT, Landmark *>> tracks;
+        tracks.reserve(veta.structure.size());
+        for (auto &[lmId, lm]: veta.structure) {
+            tracks.emplace_back(lmId, &lm);
+        }
+
+        TriangulationReport report;
+        const std::size_t batchSize = std::max<std::size_t>(options.batchSize, 1);
+        const std::size_t minCount = std::max<std::size_t>(options.minObservations, 2);
+        for (std::size_t b0 = 0; b0 < tracks.size(); b0 += batchSize) {
+            const std::size_t b1 = std::min(tracks.size(), b0 + batchSize), n = b1 - b0;
+
+            // the observations of views with a pose and an intrinsic, flattened by track
+            std::vector<std::size_t> offsets(n + 1, 0);
+            ParallelFor(0, n, [&](std::size_t i) {
+                std::size_t count = 0;
+                for (const auto &[viewId, obs]: tracks[b0 + i].second->obs) {
+                    count += slotOfView.count(viewId);
+                }
+                offsets[i + 1] = count;
+            }, 1024);
+            for (std::size_t i = 0; i < n; ++i) {
+                offsets[i + 1] += offsets[i];
+            }
+            const std::size_t m = offsets[n];
+            std::vector<uint32_t> obsSlot(m);
+            Mat2Xd pixels(2, m);
+            ParallelFor(0, n, [&](std::size_t i) {
+                std::size_t k = offsets[i];
+                for (const auto &[viewId, obs]: tracks[b0 + i].second->obs) {
+                    auto iter = slotOfView.find(viewId);
+                    if (iter != slotOfView.cend()) {
+                        obsSlot[k] = iter->second;
+                        pixels.col(static_cast<Eigen::Index>(k)) = obs.x.cast<double>();
+                        ++k;
+                    }
+                }
+            }, 1024);
+
+            // unproject the observations, in one batch per intrinsic
+            std::vector<std::vector<std::size_t>> byIntrinsic(intrinsics.size());
+            for (std::size_t k = 0; k < m; ++k) {
+                byIntrinsic[slots[obsSlot[k]].intrinsic].push_back(k);
+            }
+            Mat3Xd bearings(3, m);
+            for (std::size_t g = 0; g < intrinsics.size(); ++g) {
+                const auto &indices = byIntrinsic[g];
+                if (indices.empty()) {
+                    continue;
+                }
+                Mat2Xd p(2, indices.size());
+                for (std::size_t j = 0; j < indices.size(); ++j) {
+                    p.col(static_cast<Eigen::Index>(j)) = pixels.col(static_cast<Eigen::Index>(indices[j]));
+                }
+                const Mat3Xd groupBearings = (*intrinsics[g])(p);
+                for (std::size_t j = 0; j < indices.size(); ++j) {
+                    bearings.col(static_cast<Eigen::Index>(indices[j])) =
+                            groupBearings.col(static_cast<Eigen::Index>(j));
+                }
+            }
+
+            // solve each track
+            std::vector<Vec3d> points(n, Vec3d::Zero());
+            std::vector<TriangulationQuality> quality(n);
+            std::vector<uint8_t> solved(n, 0);
+            ParallelFor(0, n, [&](std::size_t i) {
+                const TrackView track{slots, obsSlot.data() + offsets[i], bearings,
+                                      static_cast<Eigen::Index>(offsets[i]), offsets[i + 1] - offsets[i]};
+                quality[i].observations = track.count;
+                if (track.count < minCount) {
+                    return;
+                }
+                Vec3d X;
+                const bool ok = options.method == TriangulationMethod::DLT ? SolveDLT(track, X)
+                                                                           : SolveMidpoint(track, X);
+                if (!ok) {
+                    return;
+                }
+                if (options.refineIterations > 0) {
+                    Refine(track, X, options.refineIterations);
+                }
+                points[i] = X;
+                quality[i].maxAngle = MaxAngle(track);
+                solved[i] = InFront(track, X) ? 1 : 0;
+            }, 256);
+
+            // reprojection errors, in one batch per intrinsic
+            std::vector<double> errors(m, std::numeric_limits<double>::max());
+            std::vector<std::size_t> trackOfObs(m);
+            for (std::size_t i = 0; i < n; ++i) {
+                std::fill(trackOfObs.begin() + static_cast<std::ptrdiff_t>(offsets[i]),
+                          trackOfObs.begin() + static_cast<std::ptrdiff_t>(offsets[i + 1]), i);
+            }
+            for (std::size_t g = 0; g < intrinsics.size(); ++g) {
+                std::vector<std::size_t> indices;
+                indices.reserve(byIntrinsic[g].size());
+                for (const std::size_t k: byIntrinsic[g]) {
+                    if (solved[trackOfObs[k]]) {
+                        indices.push_back(k);
+                    }
+                }
+                if (indices.empty()) {
+                    continue;
+                }
+                Mat3Xd Xc(3, indices.size());
+                Mat2Xd x(2, indices.size());
+                for (std::size_t j = 0; j < indices.size(); ++j) {
+                    const std::size_t k = indices[j];
+                    const ViewSlot &slot = slots[obsSlot[k]];
+                    Xc.col(static_cast<Eigen::Index>(j)) = slot.R * points[trackOfObs[k]] + slot.t;
+                    x.col(static_cast<Eigen::Index>(j)) = pixels.col(static_cast<Eigen::Index>(k));
+                }
+                const Mat2Xd residuals = intrinsics[g]->Residuals(Xc, x);
+                for (std::size_t j = 0; j < indices.size(); ++j) {
+                    errors[indices[j]] = residuals.col(static_cast<Eigen::Index>(j)).norm();
+                }
+            }
+
+            ParallelFor(0, n, [&](std::size_t i) {
+                if (!solved[i]) {
+                    return;
+                }
+                TriangulationQuality &q = quality[i];
+                double sum = 0.0, max = 0.0;
+                for (std::size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                    sum += errors[k];
+                    max = std::max(max, errors[k]);
+                }
+                q.meanReprojError = sum / static_cast<double>(q.observations);
+                q.maxReprojError = max;
+                q.valid = q.maxAngle >= options.minAngle && max <= options.maxReprojError;
+                if (q.valid && options.writeBack) {
+                    tracks[b0 + i].second->X = points[i];
+                }
+            }, 1024);
+
+            for (std::size_t i = 0; i < n; ++i) {
+                report.emplace_hint(report.end(), tracks[b0 + i].first, quality[i]);
+            }
+        }
+        return report;
+    }
+}
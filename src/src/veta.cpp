@@ -3,6 +3,7 @@
 //
 
 #include "veta/veta.h"
+#include "veta/columnar.h"
 
 namespace ns_veta {
 
@@ -59,12 +60,67 @@ namespace ns_veta {
     // veta
     // ----
 
-    Veta::Veta() = default;
+    Veta::Veta() : Veta(CurrentResource()) {}
+
+#ifdef VETA_ARENA_CONTAINERS
+
+    Veta::Veta(std::shared_ptr<std::pmr::memory_resource> resource)
+            : resource(std::move(resource)), views(Views::allocator_type(this->resource.get())),
+              poses(Poses::allocator_type(this->resource.get())),
+              intrinsics(Intrinsics::allocator_type(this->resource.get())),
+              structure(Landmarks::allocator_type(this->resource.get())) {}
+
+#else
+
+    Veta::Veta(std::shared_ptr<std::pmr::memory_resource> resource) : resource(std::move(resource)) {}
+
+#endif
+
+    Veta::Veta(const Veta &other) : Veta(other.resource) {
+        // the containers copy into the allocators of this scene, their elements (and so the nested containers) are
+        // copy-constructed from the current resource
+        const ScopedResource scope(resource);
+        views = other.views;
+        poses = other.poses;
+        intrinsics = other.intrinsics;
+        structure = other.structure;
+    }
+
+    Veta &Veta::operator=(const Veta &other) {
+        if (this != &other) {
+            const ScopedResource scope(resource);
+            views = other.views;
+            poses = other.poses;
+            intrinsics = other.intrinsics;
+            structure = other.structure;
+        }
+        return *this;
+    }
+
+    Veta &Veta::operator=(Veta &&other) {
+        if (this != &other) {
+            const std::shared_ptr<std::pmr::memory_resource> previous = std::move(resource);
+            views = std::move(other.views);
+            poses = std::move(other.poses);
+            intrinsics = std::move(other.intrinsics);
+            structure = std::move(other.structure);
+            resource = std::move(other.resource);
+        }
+        return *this;
+    }
 
     Veta::Ptr Veta::Create() {
         return std::make_shared<Veta>();
     }
 
+    Veta::Ptr Veta::Create(std::shared_ptr<std::pmr::memory_resource> resource) {
+        return std::make_shared<Veta>(std::move(resource));
+    }
+
+    const std::shared_ptr<std::pmr::memory_resource> &Veta::Resource() const {
+        return resource;
+    }
+
     bool ValidIds(const Veta &veta, Veta::Parts flag) {
 
         std::set<IndexT> intrinsicsIdSet; // unique so we can use a set
@@ -114,6 +170,8 @@ namespace ns_veta {
             bStatus = LoadCereal<cereal::PortableBinaryInputArchive>(veta, filename, flag);
         else if (ext == "xml")
             bStatus = LoadCereal<cereal::XMLInputArchive>(veta, filename, flag);
+        else if (ext == "vetac")
+            bStatus = LoadColumnar(veta, filename, flag);
         else {
             std::cerr << "Unknown veta input format: " << filename;
             return false;
@@ -127,14 +185,17 @@ namespace ns_veta {
         return bStatus;
     }
 
-    bool Save(const Veta &veta, const std::string &filename, Veta::Parts flag) {
+    bool Save(const Veta &veta, const std::string &filename, Veta::Parts flag, ObsEncoding encoding) {
         const std::string ext = ExtensionPart(filename);
         if (ext == "json")
-            return SaveCereal<cereal::JSONOutputArchive>(veta, filename, flag);
+            return SaveCereal<cereal::JSONOutputArchive>(veta, filename, flag, encoding);
         else if (ext == "bin")
-            return SaveCereal<cereal::PortableBinaryOutputArchive>(veta, filename, flag);
+            return SaveCereal<cereal::PortableBinaryOutputArchive>(veta, filename, flag, encoding);
         else if (ext == "xml")
-            return SaveCereal<cereal::XMLOutputArchive>(veta, filename, flag);
+            return SaveCereal<cereal::XMLOutputArchive>(veta, filename, flag, encoding);
+        else if (ext == "vetac")
+            // the columnar format is lossless, 'encoding' does not apply
+            return SaveColumnar(veta, filename, flag);
         else {
             std::cerr << "Unknown veta export format: " << filename;
         }
@@ -0,0 +1,220 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/view_pool.h"
+#include "veta/columnar.h"
+#include <cstring>
+
+namespace ns_veta {
+
+    namespace {
+        template<typename archiveType>
+        ObsEncoding LoadViewsPart(ViewPool &pool, std::istream &stream) {
+            archiveType archive(stream);
+            const ObsEncoding encoding = LoadVetaHeader(archive);
+            // the views come first, the rest of the file is not needed
+            archive(cereal::make_nvp("views", pool));
+            return encoding;
+        }
+
+        template<typename archiveType>
+        void SaveViewsParts(const ViewPool &pool, std::ostream &stream, ObsEncoding encoding, bool withStructure) {
+            archiveType archive(stream);
+            SaveVetaHeader(archive, encoding);
+            archive(cereal::make_nvp("views", pool));
+            archive(cereal::make_nvp("intrinsics", Intrinsics()));
+            archive(cereal::make_nvp("extrinsics", Poses()));
+            if (withStructure) {
+                archive(cereal::make_nvp("structure", Landmarks()));
+            }
+        }
+    }
+
+    ViewPool::ViewPool(const Views &views) {
+        Reserve(views.size());
+        for (const auto &[viewId, view]: views) {
+            if (view) {
+                View copy = *view;
+                copy.viewId = viewId;
+                Insert(copy);
+            }
+        }
+    }
+
+    ViewPool::Ptr ViewPool::Create(const Views &views) {
+        return std::make_shared<ViewPool>(views);
+    }
+
+    void ViewPool::Reserve(std::size_t size) {
+        slots.reserve(size);
+        index.reserve(size);
+    }
+
+    void ViewPool::Clear() {
+        slots.clear();
+        freeSlots.clear();
+        index.clear();
+    }
+
+    std::size_t ViewPool::Size() const {
+        return index.size();
+    }
+
+    bool ViewPool::Empty() const {
+        return index.empty();
+    }
+
+    ViewPool::Handle ViewPool::Insert(const View &view) {
+        auto iter = index.end();
+        if (!index.empty() && index.back().first >= view.viewId) {
+            iter = std::lower_bound(index.begin(), index.end(), view.viewId,
+                                    [](const std::pair<IndexT, Handle> &item, IndexT viewId) {
+                                        return item.first < viewId;
+                                    });
+            if (iter != index.end() && iter->first == view.viewId) {
+                slots[iter->second] = view;
+                return iter->second;
+            }
+        }
+        Handle handle;
+        if (!freeSlots.empty()) {
+            handle = freeSlots.back();
+            freeSlots.pop_back();
+            slots[handle] = view;
+        } else {
+            if (slots.size() >= InvalidHandle) {
+                throw std::length_error("the view pool is full");
+            }
+            handle = static_cast<Handle>(slots.size());
+            slots.push_back(view);
+        }
+        index.insert(iter, {view.viewId, handle});
+        return handle;
+    }
+
+    bool ViewPool::Erase(IndexT viewId) {
+        auto iter = std::lower_bound(index.begin(), index.end(), viewId,
+                                     [](const std::pair<IndexT, Handle> &item, IndexT id) {
+                                         return item.first < id;
+                                     });
+        if (iter == index.end() || iter->first != viewId) {
+            return false;
+        }
+        freeSlots.push_back(iter->second);
+        index.erase(iter);
+        return true;
+    }
+
+    ViewPool::Handle ViewPool::Find(IndexT viewId) const {
+        auto iter = std::lower_bound(index.cbegin(), index.cend(), viewId,
+                                     [](const std::pair<IndexT, Handle> &item, IndexT id) {
+                                         return item.first < id;
+                                     });
+        if (iter == index.cend() || iter->first != viewId) {
+            return InvalidHandle;
+        }
+        return iter->second;
+    }
+
+    const View *ViewPool::Get(IndexT viewId) const {
+        const Handle handle = Find(viewId);
+        return handle == InvalidHandle ? nullptr : &slots[handle];
+    }
+
+    View *ViewPool::Get(IndexT viewId) {
+        const Handle handle = Find(viewId);
+        return handle == InvalidHandle ? nullptr : &slots[handle];
+    }
+
+    const View &ViewPool::operator[](Handle handle) const {
+        return slots[handle];
+    }
+
+    View &ViewPool::operator[](Handle handle) {
+        return slots[handle];
+    }
+
+    const std::vector<std::pair<IndexT, ViewPool::Handle>> &ViewPool::Index() const {
+        return index;
+    }
+
+    Views ViewPool::ToViews() const {
+        Views views;
+        for (const auto &[viewId, handle]: index) {
+            views.emplace_hint(views.end(), viewId, std::make_shared<View>(slots[handle]));
+        }
+        return views;
+    }
+
+    bool LoadViews(ViewPool &pool, const std::string &filename, ObsEncoding *encoding) {
+        const std::string ext = ExtensionPart(filename);
+        if (ext != "json" && ext != "bin" && ext != "xml" && ext != "vetac") {
+            std::cerr << "Unknown veta input format: " << filename;
+            return false;
+        }
+        std::ifstream stream(filename, std::ios::binary | std::ios::in);
+        if (!stream) {
+            return false;
+        }
+        ObsEncoding fileEncoding = ObsEncoding::DOUBLE;
+        try {
+            if (ext == "json") {
+                fileEncoding = LoadViewsPart<cereal::JSONInputArchive>(pool, stream);
+            } else if (ext == "bin") {
+                fileEncoding = LoadViewsPart<cereal::PortableBinaryInputArchive>(pool, stream);
+            } else if (ext == "xml") {
+                fileEncoding = LoadViewsPart<cereal::XMLInputArchive>(pool, stream);
+            } else {
+                char magic[sizeof(ColumnarFormat::Magic)];
+                stream.read(magic, sizeof(magic));
+                if (!stream || std::memcmp(magic, ColumnarFormat::Magic, sizeof(magic)) != 0) {
+                    std::cerr << "The file '" << filename << "' is not a '.vetac' file";
+                    return false;
+                }
+                fileEncoding = LoadViewsPart<cereal::PortableBinaryInputArchive>(pool, stream);
+            }
+        }
+        catch (const cereal::Exception &e) {
+            std::cerr << e.what();
+            pool.Clear();
+            return false;
+        }
+        if (encoding != nullptr) {
+            *encoding = fileEncoding;
+        }
+        return true;
+    }
+
+    bool SaveViews(const ViewPool &pool, const std::string &filename, ObsEncoding encoding) {
+        const std::string ext = ExtensionPart(filename);
+        if (ext != "json" && ext != "bin" && ext != "xml" && ext != "vetac") {
+            std::cerr << "Unknown veta export format: " << filename;
+            return false;
+        }
+        std::ofstream stream(filename, std::ios::binary | std::ios::out);
+        if (!stream) {
+            return false;
+        }
+        if (ext == "json") {
+            SaveViewsParts<cereal::JSONOutputArchive>(pool, stream, encoding, true);
+        } else if (ext == "bin") {
+            SaveViewsParts<cereal::PortableBinaryOutputArchive>(pool, stream, encoding, true);
+        } else if (ext == "xml") {
+            SaveViewsParts<cereal::XMLOutputArchive>(pool, stream, encoding, true);
+        } else {
+            stream.write(ColumnarFormat::Magic, sizeof(ColumnarFormat::Magic));
+            // the columnar format is lossless, 'encoding' does not apply (see 'SaveColumnar')
+            SaveViewsParts<cereal::PortableBinaryOutputArchive>(pool, stream, ObsEncoding::DOUBLE, false);
+            // no landmark and no block (see 'SaveColumnar')
+            ByteWriter writer;
+            writer.PutVarUInt(0);
+            writer.PutVarUInt(0);
+            stream.write(reinterpret_cast<const char *>(writer.Buffer().data()),
+                         static_cast<std::streamsize>(writer.Size()));
+        }
+        const bool bOk = static_cast<bool>(stream);
+        stream.close();
+        return bOk;
+    }
+}
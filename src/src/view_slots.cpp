@@ -0,0 +1,63 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "view_slots.h"
+
+namespace ns_veta {
+
+    ViewSlots ViewSlots::Build(const Veta &veta, bool complete) {
+        ViewSlots result;
+        std::map<IndexT, std::size_t> intrinsicIdx;
+        for (const auto &[viewId, view]: veta.views) {
+            ViewSlot slot;
+            slot.viewId = viewId;
+            if (view) {
+                auto poseIter = veta.poses.find(view->poseId);
+                if (poseIter != veta.poses.cend()) {
+                    slot.posed = true;
+                    slot.R = poseIter->second.Rotation().matrix();
+                    slot.t = poseIter->second.Translation();
+                    slot.C = -slot.R.transpose() * slot.t;
+                }
+                auto intrinsicIter = veta.intrinsics.find(view->intrinsicId);
+                if (slot.posed && intrinsicIter != veta.intrinsics.cend() && intrinsicIter->second) {
+                    auto [iter, inserted] = intrinsicIdx.insert({view->intrinsicId, result.intrinsics.size()});
+                    if (inserted) {
+                        result.intrinsicIds.push_back(view->intrinsicId);
+                        result.intrinsics.push_back(intrinsicIter->second.get());
+                    }
+                    slot.intrinsic = iter->second;
+                    slot.hasIntrinsic = true;
+                }
+            }
+            if (complete && !slot.hasIntrinsic) {
+                continue;
+            }
+            result.slotOfView.emplace_hint(result.slotOfView.end(), viewId,
+                                           static_cast<uint32_t>(result.slots.size()));
+            result.slots.push_back(slot);
+        }
+        return result;
+    }
+
+    double MaxRayAngle(const std::vector<Vec3d> &rays) {
+        double minCos = 1.0;
+        for (std::size_t j = 1; j < rays.size(); ++j) {
+            for (std::size_t k = 0; k < j; ++k) {
+                minCos = std::min(minCos, rays[j].dot(rays[k]));
+            }
+        }
+        return std::acos(std::clamp(minCos, -1.0, 1.0)) * 180.0 / M_PI;
+    }
+
+    double MaxDistance(const std::vector<Vec3d> &points) {
+        double maxSq = 0.0;
+        for (std::size_t j = 1; j < points.size(); ++j) {
+            for (std::size_t k = 0; k < j; ++k) {
+                maxSq = std::max(maxSq, (points[j] - points[k]).squaredNorm());
+            }
+        }
+        return std::sqrt(maxSq);
+    }
+}
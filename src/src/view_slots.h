@@ -0,0 +1,57 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#ifndef VETA_VIEW_SLOTS_H
+#define VETA_VIEW_SLOTS_H
+
+#include "veta/veta.h"
+
+namespace ns_veta {
+
+    /**
+    * @brief a view with its pose and intrinsic looked up once, for the passes over the landmarks
+    */
+    struct ViewSlot {
+    public:
+        IndexT viewId = UndefinedIndexT;
+        // whether the view has a pose, then world to camera and camera center
+        bool posed = false;
+        Mat3d R = Mat3d::Identity();
+        Vec3d t = Vec3d::Zero(), C = Vec3d::Zero();
+        // whether the view is posed and has an intrinsic, then its index in 'ViewSlots::intrinsics'
+        bool hasIntrinsic = false;
+        std::size_t intrinsic = 0;
+    };
+
+    /**
+    * @brief the slots of the views of a scene and the intrinsics they use
+    */
+    struct ViewSlots {
+    public:
+        std::vector<ViewSlot> slots;
+        // the slot of each view
+        HashMap<IndexT, uint32_t> slotOfView;
+        // the intrinsics of the posed views, and their ids
+        std::vector<const IntrinsicBase *> intrinsics;
+        std::vector<IndexT> intrinsicIds;
+
+        /**
+        * @param complete only the views with a pose and an intrinsic get a slot, otherwise all the views (null
+        * ones included)
+        */
+        static ViewSlots Build(const Veta &veta, bool complete);
+    };
+
+    /**
+    * @brief the maximum angle (degrees) between two of the unit rays
+    */
+    double MaxRayAngle(const std::vector<Vec3d> &rays);
+
+    /**
+    * @brief the maximum distance between two of the points
+    */
+    double MaxDistance(const std::vector<Vec3d> &points);
+}
+
+#endif //VETA_VIEW_SLOTS_H
@@ -0,0 +1,156 @@
+//
+// Created by csl on 10/18/26.
+//
+
+#include "veta/visibility.h"
+#include "veta/simd.h"
+
+namespace ns_veta {
+
+    std::vector<uint8_t> VisibleMask(const Mat3Xd &X, const Posed &worldToCam, const IntrinsicBase &intrinsic,
+                                     double width, double height, const VisibilityOptions &options) {
+        const auto count = X.cols();
+        std::vector<uint8_t> mask(count, 0);
+        if (count == 0) {
+            return mask;
+        }
+        const Mat3d R = worldToCam.Rotation().matrix();
+        Mat3Xd pc(3, count);
+        const Vec3d t = worldToCam.Translation();
+        SimdDispatch::Kernels().transformPoints(R.data(), t.data(), X.data(), pc.data(), count);
+
+        // cheirality: the depth is the distance for spherical cameras, along the optical axis otherwise
+        const bool spherical = IsSpherical(intrinsic.GetType());
+        const Eigen::ArrayXd depth = spherical ? Eigen::ArrayXd(pc.colwise().norm().transpose())
+                                               : Eigen::ArrayXd(pc.row(2).transpose());
+        const auto inFront = (depth > options.minDepth && depth < options.maxDepth).eval();
+
+        // only project the landmarks in front of the camera
+        std::vector<Mat3Xd::Index> front;
+        front.reserve(count);
+        for (Mat3Xd::Index i = 0; i < count; ++i) {
+            if (inFront(i)) {
+                front.push_back(i);
+            }
+        }
+        Mat3Xd candidates(3, front.size());
+        for (std::size_t j = 0; j < front.size(); ++j) {
+            candidates.col(static_cast<Mat3Xd::Index>(j)) = pc.col(front[j]);
+        }
+        const Mat2Xd px = intrinsic.ProjectPoints(candidates, options.ignoreDisto);
+
+        const double b = options.border;
+        const auto inImage = (px.row(0).array() >= b && px.row(0).array() <= width - b &&
+                              px.row(1).array() >= b && px.row(1).array() <= height - b).eval();
+        for (std::size_t j = 0; j < front.size(); ++j) {
+            mask[front[j]] = inImage(static_cast<Eigen::Index>(j));
+        }
+        return mask;
+    }
+
+    Visibility ComputeVisibility(const Veta &veta, const std::vector<IndexT> &viewIds,
+                                 const LandmarkKdTree *index, const VisibilityOptions &options) {
+        // the views having a pose and an intrinsic
+        struct Job {
+            IndexT viewId;
+            const Posed *pose;
+            const IntrinsicBase *intrinsic;
+            double width, height;
+        };
+        std::vector<Job> jobs;
+        auto addJob = [&](const View &view) {
+            auto poseIter = veta.poses.find(view.poseId);
+            auto intriIter = veta.intrinsics.find(view.intrinsicId);
+            if (poseIter == veta.poses.cend() || intriIter == veta.intrinsics.cend() || !intriIter->second) {
+                return;
+            }
+            const IntrinsicBase &intrinsic = *intriIter->second;
+            const double width = view.imgWidth != UndefinedIndexT ? double(view.imgWidth) : intrinsic.Width();
+            const double height = view.imgHeight != UndefinedIndexT ? double(view.imgHeight) : intrinsic.Height();
+            jobs.push_back({view.viewId, &poseIter->second, &intrinsic, width, height});
+        };
+        if (viewIds.empty()) {
+            for (const auto &[viewId, view]: veta.views) {
+                if (view) {
+                    addJob(*view);
+                }
+            }
+        } else {
+            for (const IndexT viewId: viewIds) {
+                auto iter = veta.views.find(viewId);
+                if (iter != veta.views.cend() && iter->second) {
+                    addJob(*iter->second);
+                }
+            }
+        }
+
+        // landmarks packed once, used when no spatial index is given
+        std::vector<IndexT> allIds;
+        Mat3Xd allX;
+        auto packAll = [&veta, &allIds, &allX]() {
+            allIds.reserve(veta.structure.size());
+            allX.resize(3, static_cast<Mat3Xd::Index>(veta.structure.size()));
+            for (const auto &[lmId, lm]: veta.structure) {
+                allX.col(static_cast<Mat3Xd::Index>(allIds.size())) = lm.X;
+                allIds.push_back(lmId);
+            }
+        };
+        if (std::any_of(jobs.cbegin(), jobs.cend(), [index](const Job &job) {
+            return !index || !IsPinhole(job.intrinsic->GetType());
+        })) {
+            packAll();
+        }
+
+        const std::size_t batchSize = std::max<std::size_t>(options.batchSize, 1);
+        std::vector<std::vector<IndexT>> results(jobs.size());
+        ParallelFor(0, jobs.size(), [&](std::size_t j) {
+            const Job &job = jobs[j];
+            std::vector<IndexT> &visible = results[j];
+
+            // candidates
+            const std::vector<IndexT> *ids = &allIds;
+            const Mat3Xd *X = &allX;
+            std::vector<IndexT> culledIds;
+            Mat3Xd culledX;
+            if (index && IsPinhole(job.intrinsic->GetType())) {
+                const Frustum frustum = Frustum::FromView(
+                        *job.pose, *job.intrinsic, job.width, job.height, options.minDepth, options.maxDepth
+                );
+                std::vector<Vec3d> points;
+                index->Traverse(
+                        [&frustum](const AABB &box) { return frustum.Classify(box); },
+                        [&frustum](const Vec3d &p) { return frustum.Contains(p); },
+                        [&](IndexT lmId, const Vec3d &p) {
+                            culledIds.push_back(lmId);
+                            points.push_back(p);
+                        }
+                );
+                // 'Vec3d' are packed, so the vector can be viewed as a 3xN matrix
+                culledX = Eigen::Map<const Mat3Xd>(
+                        points.empty() ? nullptr : points.front().data(), 3, static_cast<Eigen::Index>(points.size())
+                );
+                ids = &culledIds;
+                X = &culledX;
+            }
+
+            // project batch by batch
+            for (std::size_t begin = 0; begin < ids->size(); begin += batchSize) {
+                const std::size_t size = std::min(batchSize, ids->size() - begin);
+                const Mat3Xd block = X->middleCols(static_cast<Eigen::Index>(begin), static_cast<Eigen::Index>(size));
+                const auto mask = VisibleMask(block, *job.pose, *job.intrinsic, job.width, job.height, options);
+                for (std::size_t i = 0; i < size; ++i) {
+                    if (mask[i]) {
+                        visible.push_back((*ids)[begin + i]);
+                    }
+                }
+            }
+            std::sort(visible.begin(), visible.end());
+        }, 1);
+
+        Visibility visibility;
+        for (std::size_t j = 0; j < jobs.size(); ++j) {
+            visibility.emplace(jobs[j].viewId, std::move(results[j]));
+        }
+        return visibility;
+    }
+}
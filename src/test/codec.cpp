@@ -0,0 +1,192 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// Round trips of the primitive encoders of the columnar format (see 'codec.h'): variable length integers,
+// xor-compressed doubles, the LZ codec and the columns, and the rejection of truncated or corrupted inputs
+
+#include "iostream"
+#include "random"
+#include "cstring"
+#include "veta/codec.h"
+
+namespace {
+    int failures = 0;
+
+    void Check(bool ok, const std::string &what) {
+        if (!ok) {
+            ++failures;
+            std::cerr << what << " failed" << std::endl;
+        }
+    }
+
+    template<typename Func>
+    void CheckThrows(Func &&func, const std::string &what) {
+        try {
+            func();
+        } catch (const std::runtime_error &) {
+            return;
+        }
+        Check(false, what + " (no exception)");
+    }
+
+    void CheckVarInts() {
+        const uint64_t unsignedValues[] = {0, 1, 127, 128, 255, 16383, 16384, (uint64_t(1) << 32) - 1,
+                                           uint64_t(1) << 63, std::numeric_limits<uint64_t>::max()};
+        const int64_t signedValues[] = {0, 1, -1, 63, -64, 64, -65, std::numeric_limits<int64_t>::max(),
+                                        std::numeric_limits<int64_t>::min()};
+        ns_veta::ByteWriter writer;
+        for (const uint64_t v: unsignedValues) {
+            writer.PutVarUInt(v);
+        }
+        for (const int64_t v: signedValues) {
+            writer.PutVarInt(v);
+        }
+        ns_veta::ByteReader reader(writer.Buffer().data(), writer.Size());
+        bool ok = true;
+        for (const uint64_t v: unsignedValues) {
+            ok &= reader.GetVarUInt() == v;
+        }
+        for (const int64_t v: signedValues) {
+            ok &= reader.GetVarInt() == v;
+        }
+        Check(ok && reader.AtEnd(), "varint round trip");
+
+        // a truncated integer, and one longer than 64 bits
+        const uint8_t truncated[] = {0x80, 0x80};
+        CheckThrows([&]() {
+            ns_veta::ByteReader r(truncated, sizeof(truncated));
+            r.GetVarUInt();
+        }, "truncated varint");
+        const std::vector<uint8_t> overlong(10, 0xFF);
+        CheckThrows([&]() {
+            ns_veta::ByteReader r(overlong.data(), overlong.size());
+            r.GetVarUInt();
+        }, "overlong varint");
+    }
+
+    void CheckXorDoubles() {
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<double> uniform(-1E3, 1E3);
+        std::vector<double> values{0.0, -0.0, 1.0, 1.0, 1.0, std::numeric_limits<double>::infinity(),
+                                   -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN(),
+                                   std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::max(),
+                                   std::numeric_limits<double>::lowest()};
+        for (int i = 0; i < 10000; ++i) {
+            // smooth, repeated and random values
+            values.push_back(i % 3 == 0 ? 0.5 * i : (i % 3 == 1 ? values.back() : uniform(rng)));
+        }
+        ns_veta::ByteWriter writer;
+        ns_veta::PutXorDoubles(writer, values.data(), values.size());
+        ns_veta::ByteReader reader(writer.Buffer().data(), writer.Size());
+        std::vector<double> decoded(values.size());
+        ns_veta::GetXorDoubles(reader, decoded.data(), decoded.size());
+        // bitwise comparison, for the signed zeros and the NaN
+        Check(std::memcmp(values.data(), decoded.data(), values.size() * sizeof(double)) == 0 && reader.AtEnd(),
+              "xor doubles round trip");
+
+        CheckThrows([&]() {
+            ns_veta::ByteReader r(writer.Buffer().data(), writer.Size() - 1);
+            ns_veta::GetXorDoubles(r, decoded.data(), decoded.size());
+        }, "truncated xor doubles");
+        // more bytes than a double holds
+        const uint8_t malformed[] = {0x19};
+        CheckThrows([&]() {
+            ns_veta::ByteReader r(malformed, sizeof(malformed));
+            ns_veta::GetXorDoubles(r, decoded.data(), 1);
+        }, "malformed xor double");
+    }
+
+    std::vector<std::vector<uint8_t>> LzInputs() {
+        std::mt19937 rng(4);
+        std::uniform_int_distribution<int> byte(0, 255), small(0, 3);
+        std::vector<std::vector<uint8_t>> inputs;
+        inputs.emplace_back();
+        inputs.push_back({42});
+        inputs.push_back({1, 2, 3});
+        // a long run (overlapping matches)
+        inputs.emplace_back(100000, 7);
+        // random bytes, incompressible
+        std::vector<uint8_t> random(70000);
+        for (auto &b: random) {
+            b = static_cast<uint8_t>(byte(rng));
+        }
+        inputs.push_back(random);
+        // a small alphabet, and a pattern repeated beyond the window of 64 KiB
+        std::vector<uint8_t> alphabet(200000), pattern;
+        for (auto &b: alphabet) {
+            b = static_cast<uint8_t>(small(rng));
+        }
+        inputs.push_back(alphabet);
+        for (int i = 0; i < 5; ++i) {
+            pattern.insert(pattern.end(), random.begin(), random.end());
+        }
+        inputs.push_back(pattern);
+        return inputs;
+    }
+
+    void CheckLz() {
+        for (const auto &input: LzInputs()) {
+            const std::string what = "lz round trip of " + std::to_string(input.size()) + " bytes";
+            const std::vector<uint8_t> packed = ns_veta::LzCompress(input.data(), input.size());
+            Check(ns_veta::LzDecompress(packed.data(), packed.size(), input.size()) == input, what);
+            if (input.size() < 16) {
+                continue;
+            }
+            // a wrong raw size, and a truncated block
+            CheckThrows([&]() {
+                ns_veta::LzDecompress(packed.data(), packed.size(), input.size() - 1);
+            }, what + ", smaller raw size");
+            CheckThrows([&]() {
+                ns_veta::LzDecompress(packed.data(), packed.size(), input.size() + 1);
+            }, what + ", larger raw size");
+            CheckThrows([&]() {
+                ns_veta::LzDecompress(packed.data(), packed.size() / 2, input.size());
+            }, what + ", truncated");
+        }
+        // a match before the beginning of the output
+        const uint8_t badOffset[] = {0x10, 'a', 0x05, 0x00};
+        CheckThrows([&]() {
+            ns_veta::LzDecompress(badOffset, sizeof(badOffset), 16);
+        }, "lz match out of the output");
+    }
+
+    void CheckColumns() {
+        ns_veta::ByteWriter writer;
+        const auto inputs = LzInputs();
+        for (const auto &input: inputs) {
+            ns_veta::PutColumn(writer, input);
+        }
+        ns_veta::ByteReader reader(writer.Buffer().data(), writer.Size());
+        bool ok = true;
+        for (const auto &input: inputs) {
+            ok &= ns_veta::GetColumn(reader) == input;
+        }
+        Check(ok && reader.AtEnd(), "columns round trip");
+
+        // an unknown codec, and a raw column of inconsistent sizes
+        const uint8_t unknownCodec[] = {0x01, 0x07, 0x01, 0x00};
+        CheckThrows([&]() {
+            ns_veta::ByteReader r(unknownCodec, sizeof(unknownCodec));
+            ns_veta::GetColumn(r);
+        }, "unknown column codec");
+        const uint8_t badRaw[] = {0x02, 0x00, 0x01, 0x00};
+        CheckThrows([&]() {
+            ns_veta::ByteReader r(badRaw, sizeof(badRaw));
+            ns_veta::GetColumn(r);
+        }, "raw column sizes");
+    }
+}
+
+int main(int argc, char **argv) {
+    CheckVarInts();
+    CheckXorDoubles();
+    CheckLz();
+    CheckColumns();
+    if (failures != 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "codec checked" << std::endl;
+    return 0;
+}
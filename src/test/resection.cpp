@@ -0,0 +1,142 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// Resection ('Resect', 'ResectViews') of synthetic views: random poses, points projected through a distorted
+// pinhole camera and a share of the observations replaced by random pixels, the recovered poses and inliers
+// are compared to the ground truth
+
+#include "iostream"
+#include "random"
+#include "veta/resection.h"
+#include "veta/camera/pinhole_radial.h"
+
+namespace {
+    int failures = 0;
+
+    void Check(bool ok, const std::string &what) {
+        if (!ok) {
+            ++failures;
+            std::cerr << what << " failed" << std::endl;
+        }
+    }
+
+    // 2D-3D correspondences of a view, the first 'inliers' ones are exact and the others outliers
+    struct Correspondences {
+    public:
+        ns_veta::Posed pose;
+        ns_veta::Mat3Xd X;
+        ns_veta::Mat2Xd x;
+        std::size_t inliers = 0;
+    };
+
+    Correspondences MakeCorrespondences(const ns_veta::IntrinsicBase &intrinsic, std::mt19937 &rng,
+                                        std::size_t count, double outlierRatio) {
+        std::uniform_real_distribution<double> unit(-1.0, 1.0), depth(4.0, 12.0);
+        std::uniform_real_distribution<double> u(0.0, intrinsic.Width()), v(0.0, intrinsic.Height());
+
+        Correspondences c;
+        // world to camera
+        c.pose = ns_veta::Posed(Sophus::SO3d::exp(ns_veta::Vec3d(unit(rng), unit(rng), unit(rng)) * M_PI),
+                                ns_veta::Vec3d(unit(rng), unit(rng), unit(rng)) * 5.0);
+        const ns_veta::Posed cameraToWorld = c.pose.Inverse();
+
+        c.X.resize(3, static_cast<Eigen::Index>(count));
+        c.x.resize(2, static_cast<Eigen::Index>(count));
+        Eigen::Index n = 0;
+        while (n < static_cast<Eigen::Index>(count)) {
+            // in front of the camera, kept if seen in the image
+            const double z = depth(rng);
+            const ns_veta::Vec3d Xc(0.6 * z * unit(rng), 0.4 * z * unit(rng), z);
+            const ns_veta::Vec2d p = intrinsic.Project(Xc, false);
+            if (p(0) < 0.0 || p(0) >= intrinsic.Width() || p(1) < 0.0 || p(1) >= intrinsic.Height()) {
+                continue;
+            }
+            c.X.col(n) = cameraToWorld(Xc);
+            c.x.col(n) = p;
+            ++n;
+        }
+
+        // random pixels, far from the projections they replace
+        c.inliers = count - static_cast<std::size_t>(outlierRatio * static_cast<double>(count));
+        for (auto i = static_cast<Eigen::Index>(c.inliers); i < n; ++i) {
+            ns_veta::Vec2d p;
+            do {
+                p = ns_veta::Vec2d(u(rng), v(rng));
+            } while ((p - c.x.col(i)).norm() < 20.0);
+            c.x.col(i) = p;
+        }
+        return c;
+    }
+
+    bool SamePose(const ns_veta::Posed &estimated, const ns_veta::Posed &truth) {
+        const double rotError = (estimated.Rotation().inverse() * truth.Rotation()).log().norm();
+        const double posError = (estimated.Translation() - truth.Translation()).norm();
+        return rotError < 1E-6 && posError < 1E-6 * std::max(1.0, truth.Translation().norm());
+    }
+
+    void CheckResect(const ns_veta::IntrinsicBase &intrinsic) {
+        std::mt19937 rng(5);
+        ns_veta::ResectionOptions options;
+        for (int trial = 0; trial < 20; ++trial) {
+            const std::string what = "resection of trial " + std::to_string(trial);
+            const Correspondences c = MakeCorrespondences(intrinsic, rng, 100, 0.2);
+            options.seed = trial;
+            const ns_veta::ResectionResult result = ns_veta::Resect(intrinsic, c.X, c.x, options);
+            Check(result.success, what);
+            Check(result.correspondences == 100 && result.inliers == c.inliers, what + ", inliers");
+            Check(SamePose(result.pose, c.pose), what + ", pose");
+            Check(result.rmse < 1E-4, what + ", rmse");
+        }
+
+        // fewer inliers than required
+        const Correspondences c = MakeCorrespondences(intrinsic, rng, 40, 0.8);
+        Check(!ns_veta::Resect(intrinsic, c.X, c.x, options).success, "resection of too few inliers");
+    }
+
+    void CheckResectViews(const std::shared_ptr<ns_veta::IntrinsicBase> &intrinsic) {
+        std::mt19937 rng(6);
+        ns_veta::Veta veta;
+        veta.intrinsics.insert({0, intrinsic});
+        std::vector<ns_veta::Posed> truth;
+        ns_veta::IndexT lmId = 0;
+        for (ns_veta::IndexT viewId = 0; viewId < 4; ++viewId) {
+            veta.views.insert({viewId, ns_veta::View::Create(0.1 * viewId, viewId, 0, viewId,
+                                                             intrinsic->Width(), intrinsic->Height())});
+            // a track per correspondence
+            const Correspondences c = MakeCorrespondences(*intrinsic, rng, 60, 0.25);
+            for (Eigen::Index i = 0; i < c.X.cols(); ++i, ++lmId) {
+                veta.structure.insert({lmId, ns_veta::Landmark(c.X.col(i), {
+                        {viewId, ns_veta::Observation(c.x.col(i), i)}
+                })});
+            }
+            truth.push_back(c.pose);
+        }
+
+        const ns_veta::ResectionReport report =
+                ns_veta::ResectViews(veta, ns_veta::BuildViewLandmarks(veta.structure));
+        Check(report.size() == truth.size(), "resected views");
+        for (ns_veta::IndexT viewId = 0; viewId < truth.size(); ++viewId) {
+            const std::string what = "resection of view " + std::to_string(viewId);
+            auto iter = report.find(viewId);
+            Check(iter != report.cend() && iter->second.success && iter->second.inliers == 45, what);
+            // observations may be stored as floats ('VETA_COMPACT_OBSERVATION')
+            Check(veta.poses.count(viewId) != 0 &&
+                  (veta.poses.at(viewId).Rotation().inverse() * truth[viewId].Rotation()).log().norm() < 1E-4,
+                  what + ", written pose");
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const auto intrinsic = std::make_shared<ns_veta::PinholeIntrinsicRadialK3>(
+            1920, 1080, 1000.0, 1010.0, 960.0, 540.0, -0.2, 0.05, -0.01);
+    CheckResect(*intrinsic);
+    CheckResectViews(intrinsic);
+    if (failures != 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "resection checked" << std::endl;
+    return 0;
+}
@@ -0,0 +1,203 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// Accuracy of the batched kernels of every instruction set variant (see 'SimdDispatch') against the scalar
+// (libm) paths: 'FastMath' trigonometry, the spherical bearings and projections built on it, and the pinhole
+// projections, undistortions and residuals
+
+#include "iostream"
+#include "random"
+#include "veta/fast_math.h"
+#include "veta/simd.h"
+#include "veta/camera/spherical.h"
+#include "veta/camera/pinhole_radial.h"
+#include "veta/camera/pinhole_brown.h"
+#include "veta/camera/pinhole_fisheye.h"
+
+namespace {
+    int failures = 0;
+
+    void Check(bool ok, const std::string &variant, const std::string &what, double error = 0.0) {
+        if (!ok) {
+            ++failures;
+            std::cerr << "[" << variant << "] " << what << " failed, error: " << error << std::endl;
+        }
+    }
+
+    void CheckSinCos(const std::string &variant) {
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<double> small(-10.0, 10.0), large(-1E5, 1E5);
+        Eigen::ArrayXd x(200000);
+        for (Eigen::Index i = 0; i < x.size(); ++i) {
+            x(i) = i % 2 ? small(rng) : large(rng);
+        }
+        // the multiples of pi/4 and the zeros
+        for (int k = -16; k <= 16; ++k) {
+            x(k + 16) = k * M_PI / 4.0;
+        }
+        x(40) = 0.0, x(41) = -0.0;
+
+        Eigen::ArrayXd sin, cos;
+        ns_veta::FastMath::SinCos(x, sin, cos);
+        double sinError = 0.0, cosError = 0.0;
+        for (Eigen::Index i = 0; i < x.size(); ++i) {
+            sinError = std::max(sinError, std::abs(sin(i) - std::sin(x(i))));
+            cosError = std::max(cosError, std::abs(cos(i) - std::cos(x(i))));
+        }
+        Check(sinError < 5E-16, variant, "sin", sinError);
+        Check(cosError < 5E-16, variant, "cos", cosError);
+    }
+
+    void CheckAtan2(const std::string &variant) {
+        std::mt19937 rng(2);
+        std::uniform_real_distribution<double> uniform(-1E3, 1E3);
+        std::vector<std::pair<double, double>> cases;
+        for (int i = 0; i < 200000; ++i) {
+            cases.emplace_back(uniform(rng), uniform(rng));
+        }
+        const double zeros[] = {0.0, -0.0}, ones[] = {1.0, -1.0};
+        for (const double z: zeros) {
+            for (const double w: zeros) {
+                // (0, 0) with every sign
+                cases.emplace_back(z, w);
+            }
+            for (const double o: ones) {
+                // on the axes
+                cases.emplace_back(z, o);
+                cases.emplace_back(o, z);
+            }
+        }
+        Eigen::ArrayXd y(cases.size()), x(cases.size());
+        for (std::size_t i = 0; i < cases.size(); ++i) {
+            y(static_cast<Eigen::Index>(i)) = cases[i].first;
+            x(static_cast<Eigen::Index>(i)) = cases[i].second;
+        }
+
+        const Eigen::ArrayXd a = ns_veta::FastMath::Atan2(y, x);
+        double error = 0.0;
+        for (Eigen::Index i = 0; i < a.size(); ++i) {
+            const double expected = std::atan2(y(i), x(i));
+            error = std::max(error, std::abs(a(i) - expected));
+            if (y(i) == 0.0 || x(i) == 0.0) {
+                // exact, with the sign of the zeros
+                Check(a(i) == expected && std::signbit(a(i)) == std::signbit(expected), variant,
+                      "atan2(" + std::to_string(y(i)) + (std::signbit(y(i)) ? " (-)" : "") + ", " +
+                      std::to_string(x(i)) + (std::signbit(x(i)) ? " (-)" : "") + ")", a(i) - expected);
+            }
+        }
+        Check(error < 5E-16, variant, "atan2", error);
+    }
+
+    void CheckSpherical(const std::string &variant) {
+        const auto camera = ns_veta::IntrinsicSpherical::Create(4000, 2000);
+        const double w = camera->Width(), h = camera->Height(), size = std::max(w, h);
+
+        std::mt19937 rng(3);
+        std::uniform_real_distribution<double> u(0.0, w), v(0.0, h), unit(-1.0, 1.0);
+        ns_veta::Mat2Xd pixels(2, 50000);
+        for (Eigen::Index i = 0; i < pixels.cols(); ++i) {
+            pixels.col(i) << u(rng), v(rng);
+        }
+        const ns_veta::Mat3Xd bearings = (*camera)(pixels);
+        double bearingError = 0.0;
+        for (Eigen::Index i = 0; i < pixels.cols(); ++i) {
+            const double lon = (pixels(0, i) - w / 2.0) * 2.0 * M_PI / size;
+            const double lat = (pixels(1, i) - h / 2.0) * -2.0 * M_PI / size;
+            const ns_veta::Vec3d expected(std::cos(lat) * std::sin(lon), -std::sin(lat), std::cos(lat) * std::cos(lon));
+            bearingError = std::max(bearingError, (bearings.col(i) - expected).cwiseAbs().maxCoeff());
+        }
+        Check(bearingError < 1E-15, variant, "spherical bearings", bearingError);
+
+        ns_veta::Mat3Xd X(3, 50000);
+        for (Eigen::Index i = 0; i < X.cols(); ++i) {
+            X.col(i) << unit(rng), unit(rng), unit(rng);
+        }
+        // on the seam and the poles
+        X.col(0) << 0.0, 0.0, -1.0;
+        X.col(1) << -0.0, 0.0, -1.0;
+        X.col(2) << 0.0, 1.0, 0.0;
+        X.col(3) << 0.0, -1.0, 0.0;
+        const ns_veta::Mat2Xd x = camera->ProjectPoints(X, false);
+        double projectionError = 0.0;
+        for (Eigen::Index i = 0; i < X.cols(); ++i) {
+            projectionError = std::max(projectionError, (x.col(i) - camera->Project(X.col(i), false)).norm());
+        }
+        Check(projectionError < 1E-9, variant, "spherical projections", projectionError);
+    }
+
+    void CheckPinhole(const std::string &variant, const std::string &model, const ns_veta::PinholeIntrinsic &camera) {
+        std::mt19937 rng(4);
+        std::uniform_real_distribution<double> depth(1.0, 5.0), unit(-0.8, 0.8);
+        ns_veta::Mat3Xd X(3, 50000);
+        for (Eigen::Index i = 0; i < X.cols(); ++i) {
+            const double z = depth(rng);
+            X.col(i) << unit(rng) * z, unit(rng) * z, z;
+        }
+        // the principal axis
+        X.col(0) << 0.0, 0.0, 1.0;
+
+        for (const bool ignoreDisto: {false, true}) {
+            const ns_veta::Mat2Xd x = camera.ProjectPoints(X, ignoreDisto);
+            double error = 0.0;
+            for (Eigen::Index i = 0; i < X.cols(); ++i) {
+                error = std::max(error, (x.col(i) - camera.Project(X.col(i), ignoreDisto)).norm());
+            }
+            Check(error < 1E-9, variant, model + (ignoreDisto ? " projections (no distortion)" : " projections"),
+                  error);
+        }
+
+        // residuals of noisy observations
+        std::normal_distribution<double> noise(0.0, 2.0);
+        ns_veta::Mat2Xd observations = camera.ProjectPoints(X, false);
+        for (Eigen::Index i = 0; i < observations.cols(); ++i) {
+            observations.col(i) += ns_veta::Vec2d(noise(rng), noise(rng));
+        }
+        const ns_veta::Mat2Xd residuals = camera.Residuals(X, observations);
+        double residualError = 0.0;
+        for (Eigen::Index i = 0; i < X.cols(); ++i) {
+            residualError = std::max(residualError, (residuals.col(i) - camera.Residual(X.col(i), observations.col(i)))
+                    .norm());
+        }
+        Check(residualError < 1E-9, variant, model + " residuals", residualError);
+
+        // undistortion of the distorted camera plane points
+        ns_veta::Mat2Xd p(2, X.cols());
+        for (Eigen::Index i = 0; i < X.cols(); ++i) {
+            p.col(i) = camera.AddDisto(X.col(i).hnormalized());
+        }
+        const ns_veta::Mat2Xd u = camera.RemoveDistoPoints(p);
+        double undistoError = 0.0;
+        for (Eigen::Index i = 0; i < X.cols(); ++i) {
+            undistoError = std::max(undistoError, (u.col(i) - camera.RemoveDisto(p.col(i))).norm());
+        }
+        // the scalar radial solver is a bisection to 1E-10 on the squared radius
+        Check(undistoError < 1E-8, variant, model + " undistortion", undistoError);
+    }
+}
+
+int main(int argc, char **argv) {
+    for (const auto level: {ns_veta::SimdLevel::SCALAR, ns_veta::SimdLevel::AVX2, ns_veta::SimdLevel::AVX512}) {
+        if (!ns_veta::SimdDispatch::Select(level)) {
+            continue;
+        }
+        const std::string variant = ns_veta::SimdDispatch::Name();
+        CheckSinCos(variant);
+        CheckAtan2(variant);
+        CheckSpherical(variant);
+        CheckPinhole(variant, "radial k1", ns_veta::PinholeIntrinsicRadialK1(1920, 1080, 1000.0, 1010.0, 960.0, 540.0,
+                                                                             -0.2));
+        CheckPinhole(variant, "radial k3", ns_veta::PinholeIntrinsicRadialK3(1920, 1080, 1000.0, 1010.0, 960.0, 540.0,
+                                                                             -0.2, 0.05, -0.01));
+        CheckPinhole(variant, "brown", ns_veta::PinholeIntrinsicBrownT2(1920, 1080, 1000.0, 1010.0, 960.0, 540.0,
+                                                                        -0.2, 0.05, -0.01, 1E-3, -2E-3));
+        CheckPinhole(variant, "fisheye", ns_veta::PinholeIntrinsicFisheye(1920, 1080, 1000.0, 1010.0, 960.0, 540.0,
+                                                                          0.05, -0.01, 2E-3, -1E-4));
+        std::cout << "[" << variant << "] checked" << std::endl;
+    }
+    if (failures != 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// Triangulation ('Triangulate') of a synthetic scene with both methods: known points observed by 2 to 5 posed
+// views through a distorted pinhole camera are recovered, and a track of nearly parallel rays is rejected
+
+#include "iostream"
+#include "random"
+#include "map"
+#include "veta/triangulation.h"
+#include "veta/camera/pinhole_radial.h"
+
+namespace {
+    int failures = 0;
+
+    void Check(bool ok, const std::string &what) {
+        if (!ok) {
+            ++failures;
+            std::cerr << what << " failed" << std::endl;
+        }
+    }
+
+    // the views 0 to 4 are spread along the x axis, the views 5 and 6 are a millimeter apart
+    constexpr ns_veta::IndexT ParallelViews[] = {5, 6};
+    constexpr ns_veta::IndexT ParallelLandmark = 1000;
+
+    struct Scene {
+    public:
+        ns_veta::Veta veta;
+        // the points of the landmarks
+        std::map<ns_veta::IndexT, ns_veta::Vec3d> points;
+    };
+
+    void AddView(Scene &scene, ns_veta::IndexT viewId, const ns_veta::Vec3d &center, const ns_veta::Vec3d &angles) {
+        // world to camera, looking along the z axis of the world
+        const Sophus::SO3d R = Sophus::SO3d::exp(angles);
+        scene.veta.views.insert({viewId, ns_veta::View::Create(0.1 * viewId, viewId, 0, viewId, 1920, 1080)});
+        scene.veta.poses.insert({viewId, ns_veta::Posed(R, -(R * center))});
+    }
+
+    void AddLandmark(Scene &scene, ns_veta::IndexT lmId, const ns_veta::Vec3d &X,
+                     const std::vector<ns_veta::IndexT> &viewIds) {
+        const ns_veta::IntrinsicBase &intrinsic = *scene.veta.intrinsics.at(0);
+        ns_veta::Observations obs;
+        for (const ns_veta::IndexT viewId: viewIds) {
+            const ns_veta::Vec2d p = intrinsic.Project(scene.veta.poses.at(viewId)(X), false);
+            obs.insert({viewId, ns_veta::Observation(p, lmId)});
+        }
+        scene.veta.structure.insert({lmId, ns_veta::Landmark(X, obs)});
+        scene.points[lmId] = X;
+    }
+
+    Scene MakeScene() {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<double> unit(-1.0, 1.0), depth(8.0, 15.0);
+
+        Scene scene;
+        scene.veta.intrinsics.insert({0, std::make_shared<ns_veta::PinholeIntrinsicRadialK3>(
+                1920, 1080, 1000.0, 1010.0, 960.0, 540.0, -0.2, 0.05, -0.01)});
+        for (ns_veta::IndexT viewId = 0; viewId < 5; ++viewId) {
+            AddView(scene, viewId, ns_veta::Vec3d(viewId - 2.0, 0.2 * unit(rng), 0.2 * unit(rng)),
+                    ns_veta::Vec3d(unit(rng), unit(rng), unit(rng)) * 0.05);
+        }
+        AddView(scene, ParallelViews[0], ns_veta::Vec3d(0.0, 1.0, 0.0), ns_veta::Vec3d::Zero());
+        AddView(scene, ParallelViews[1], ns_veta::Vec3d(1E-3, 1.0, 0.0), ns_veta::Vec3d(0.0, 1E-3, 0.0));
+
+        // tracks of 2 to 5 consecutive views
+        ns_veta::IndexT lmId = 0;
+        for (ns_veta::IndexT count = 2; count <= 5; ++count) {
+            for (int i = 0; i < 50; ++i, ++lmId) {
+                std::vector<ns_veta::IndexT> viewIds(count);
+                const auto first = static_cast<ns_veta::IndexT>(i % (6 - count));
+                for (ns_veta::IndexT j = 0; j < count; ++j) {
+                    viewIds[j] = first + j;
+                }
+                const double z = depth(rng);
+                AddLandmark(scene, lmId, ns_veta::Vec3d(0.3 * z * unit(rng), 0.2 * z * unit(rng), z), viewIds);
+            }
+        }
+        // about 0.003 degree between the rays
+        AddLandmark(scene, ParallelLandmark, ns_veta::Vec3d(0.5, 1.5, 20.0),
+                    {ParallelViews[0], ParallelViews[1]});
+        return scene;
+    }
+
+    void CheckMethod(const Scene &truth, ns_veta::TriangulationMethod method, const std::string &name) {
+        // start from perturbed points, the valid ones are written back
+        Scene scene = truth;
+        std::mt19937 rng(8);
+        std::uniform_real_distribution<double> unit(-1.0, 1.0);
+        for (auto &[lmId, lm]: scene.veta.structure) {
+            lm.X += ns_veta::Vec3d(unit(rng), unit(rng), unit(rng));
+        }
+        const ns_veta::Vec3d parallelStart = scene.veta.structure.at(ParallelLandmark).X;
+
+        ns_veta::TriangulationOptions options;
+        options.method = method;
+        const ns_veta::TriangulationReport report = ns_veta::Triangulate(scene.veta, options);
+        Check(report.size() == truth.points.size(), name + ": reported landmarks");
+
+        for (const auto &[lmId, X]: truth.points) {
+            const std::string what = name + ": landmark " + std::to_string(lmId);
+            auto iter = report.find(lmId);
+            if (iter == report.cend()) {
+                Check(false, what + " reported");
+                continue;
+            }
+            const ns_veta::TriangulationQuality &q = iter->second;
+            const ns_veta::Landmark &lm = scene.veta.structure.at(lmId);
+            Check(q.observations == lm.obs.size(), what + ", observations");
+            if (lmId == ParallelLandmark) {
+                Check(!q.valid, what + " (parallel rays) rejected");
+                Check(lm.X == parallelStart, what + " (parallel rays) not written");
+                continue;
+            }
+            // observations may be stored as floats ('VETA_COMPACT_OBSERVATION')
+            Check(q.valid && q.maxAngle >= options.minAngle, what + " valid");
+            Check((lm.X - X).norm() < 1E-4, what + ", point");
+            Check(q.maxReprojError < 1E-3, what + ", reprojection error");
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    const Scene scene = MakeScene();
+    CheckMethod(scene, ns_veta::TriangulationMethod::DLT, "dlt");
+    CheckMethod(scene, ns_veta::TriangulationMethod::MIDPOINT, "midpoint");
+    if (failures != 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "triangulation checked" << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+//
+// Created by csl on 10/18/26.
+//
+
+// Round trip of the views between the scene files written by 'Save' and a 'ViewPool' ('LoadViews', 'SaveViews'),
+// for every format, including the views shared by several ids and the null views
+
+#include "iostream"
+#include "cstdio"
+#include "veta/view_pool.h"
+
+namespace {
+    int failures = 0;
+
+    void Check(bool ok, const std::string &format, const std::string &what) {
+        if (!ok) {
+            ++failures;
+            std::cerr << "[" << format << "] " << what << " failed" << std::endl;
+        }
+    }
+
+    bool SameView(const ns_veta::View &a, const ns_veta::View &b) {
+        return a.timestamp == b.timestamp && a.intrinsicId == b.intrinsicId && a.poseId == b.poseId &&
+               a.imgWidth == b.imgWidth && a.imgHeight == b.imgHeight;
+    }
+
+    // the views of 'views' (null ones are skipped), under the ids of their keys
+    bool SameViews(const ns_veta::Views &views, const ns_veta::ViewPool &pool) {
+        std::size_t count = 0;
+        for (const auto &[viewId, view]: views) {
+            if (!view) {
+                continue;
+            }
+            ++count;
+            const ns_veta::View *pooled = pool.Get(viewId);
+            if (pooled == nullptr || pooled->viewId != viewId || !SameView(*view, *pooled)) {
+                return false;
+            }
+        }
+        return count == pool.Size();
+    }
+
+    ns_veta::Veta MakeScene() {
+        ns_veta::Veta veta;
+        for (ns_veta::IndexT i = 0; i < 50; ++i) {
+            veta.views.insert({i, ns_veta::View::Create(0.1 * i, i, i % 3, i, 640, 480)});
+            veta.poses.insert({i, ns_veta::Posed()});
+            veta.structure.insert({i, ns_veta::Landmark(ns_veta::Vec3d(i, 2.0 * i, 1.0), {
+                    {i, ns_veta::Observation(ns_veta::Vec2d(0.5 * i, 0.25 * i), i)}
+            })});
+        }
+        // a view shared by two ids, and a null view
+        veta.views[100] = veta.views.at(7);
+        veta.views[101] = nullptr;
+        return veta;
+    }
+
+    void CheckFormat(const ns_veta::Veta &veta, const std::string &ext) {
+        const std::string sceneFile = "view_pool_scene." + ext, viewsFile = "view_pool_views." + ext;
+        std::remove(sceneFile.c_str());
+        std::remove(viewsFile.c_str());
+
+        // views of a scene file
+        Check(ns_veta::Save(veta, sceneFile, ns_veta::Veta::ALL), ext, "save the scene");
+        ns_veta::ViewPool pool;
+        ns_veta::ObsEncoding encoding = ns_veta::ObsEncoding::FIXED_POINT;
+        Check(ns_veta::LoadViews(pool, sceneFile, &encoding), ext, "load the views");
+        Check(encoding == ns_veta::ObsEncoding::DOUBLE, ext, "encoding of the scene");
+        Check(SameViews(veta.views, pool), ext, "views loaded from the scene");
+
+        // views-only file (saved twice, it is overwritten), loaded as a scene and as a pool
+        Check(ns_veta::SaveViews(pool, viewsFile), ext, "save the views");
+        Check(ns_veta::SaveViews(pool, viewsFile), ext, "overwrite the views");
+        ns_veta::Veta views;
+        Check(ns_veta::Load(views, viewsFile, ns_veta::Veta::VIEWS), ext, "load the views as a scene");
+        Check(SameViews(views.views, pool), ext, "views of the views-only scene");
+        ns_veta::ViewPool reloaded;
+        Check(ns_veta::LoadViews(reloaded, viewsFile), ext, "reload the views");
+        Check(SameViews(views.views, reloaded), ext, "reloaded views");
+
+        std::remove(sceneFile.c_str());
+        std::remove(viewsFile.c_str());
+    }
+
+    void CheckEncodedHeader(const ns_veta::Veta &veta) {
+        const std::string sceneFile = "view_pool_scene_f32.bin", viewsFile = "view_pool_views_f32.bin";
+        std::remove(sceneFile.c_str());
+        std::remove(viewsFile.c_str());
+
+        Check(ns_veta::Save(veta, sceneFile, ns_veta::Veta::ALL, ns_veta::ObsEncoding::FLOAT32), "bin",
+              "save the float32 scene");
+        ns_veta::ViewPool pool;
+        ns_veta::ObsEncoding encoding = ns_veta::ObsEncoding::DOUBLE;
+        Check(ns_veta::LoadViews(pool, sceneFile, &encoding), "bin", "load the views of the float32 scene");
+        Check(encoding == ns_veta::ObsEncoding::FLOAT32, "bin", "encoding of the float32 scene");
+        Check(ns_veta::SaveViews(pool, viewsFile, encoding), "bin", "save the views with the float32 header");
+        encoding = ns_veta::ObsEncoding::DOUBLE;
+        Check(ns_veta::LoadViews(pool, viewsFile, &encoding) && encoding == ns_veta::ObsEncoding::FLOAT32, "bin",
+              "header of the views-only file");
+
+        std::remove(sceneFile.c_str());
+        std::remove(viewsFile.c_str());
+    }
+}
+
+int main(int argc, char **argv) {
+    const ns_veta::Veta veta = MakeScene();
+    for (const std::string ext: {"json", "bin", "xml", "vetac"}) {
+        CheckFormat(veta, ext);
+        std::cout << "[" << ext << "] checked" << std::endl;
+    }
+    CheckEncodedHeader(veta);
+    if (failures != 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}